@@ -13,19 +13,25 @@ GLOBAL _irq03Handler
 GLOBAL _irq04Handler
 GLOBAL _irq05Handler
 GLOBAL _irq128Handler
+GLOBAL _lapicTimerHandler
+GLOBAL _reschedHandler
+GLOBAL _apStartHandler
+GLOBAL _spuriousHandler
 
 GLOBAL _exception0Handler
 GLOBAL _exception6Handler
+GLOBAL _exception7Handler
 
 GLOBAL get_pressed_key
 GLOBAL reg_array ; array donde se almacenan los registros cunado se toco ctrl
 
 GLOBAL setup_initial_stack 
-
-GLOBAL timer_tick ; simula un tick del timer
+GLOBAL context_switch
 
 GLOBAL _cli
 GLOBAL _sti
+GLOBAL _irq_save
+GLOBAL _irq_restore
 
 EXTERN SNAPSHOT_KEY
 EXTERN irq_dispatcher
@@ -36,6 +42,14 @@ EXTERN switch_to_rsp
 EXTERN print_registers
 EXTERN getStackBase
 EXTERN main
+EXTERN kernel_lock
+EXTERN kernel_unlock
+EXTERN lapic_eoi
+EXTERN lapic_irq_dispatcher
+EXTERN scheduler_syscall_entry
+EXTERN smp_ap_stack_top
+EXTERN smp_ap_main
+EXTERN fpu_handle_nm
 
 SECTION .text
 
@@ -75,29 +89,50 @@ SECTION .text
 	pop rbx
 %endmacro
 
+; Todas las entradas al kernel toman el lock del kernel (ver smp.c) después de guardar el
+; contexto y lo sueltan antes de restaurarlo. Si el scheduler cambia de proceso dentro del
+; dispatcher, este handler sigue recién cuando el proceso interrumpido vuelve a correr: el EOI
+; se manda antes, así el próximo proceso no corre con la interrupción sin confirmar.
 %macro irqHandlerMaster 1
 	pushState
-
-	mov rdi, %1 ; pasaje de parametro
-	mov rsi, rsp
-	call irq_dispatcher
-	mov rsp, rax
+	call kernel_lock
 
 	; EOI
 	mov al, 20h
 	out 20h, al
 
+	mov rdi, %1 ; pasaje de parametro
+	call irq_dispatcher
+
+	call kernel_unlock
+	popState
+	iretq
+%endmacro
+
+; Interrupciones entregadas por el Local APIC (timer de los APs e IPIs): el EOI va al LAPIC
+%macro lapicHandler 1
+	pushState
+	call kernel_lock
+
+	call lapic_eoi
+
+	mov rdi, %1
+	call lapic_irq_dispatcher
+
+	call kernel_unlock
 	popState
 	iretq
 %endmacro
 
 %macro exceptionHandler 1
 	pushState
+	call kernel_lock
 
 	call print_registers
 
 	mov rdi, %1 ; pasaje de parametro
 	call exception_dispatcher
+	call kernel_unlock
 
 	popState ; vuelvo a tener en [rsp] los registros que me pusheo en el stack la interrupción
 	call getStackBase	        
@@ -125,6 +160,19 @@ _sti:
 	sti
 	ret
 
+; Devuelve RFLAGS y deshabilita las interrupciones
+_irq_save:
+	pushfq
+	pop rax
+	cli
+	ret
+
+; Restaura el RFLAGS (y con él el flag de interrupciones) que devolvió _irq_save
+_irq_restore:
+	push rdi
+	popfq
+	ret
+
 picMasterMask:
 	push rbp
     mov rbp, rsp
@@ -211,11 +259,48 @@ _irq05Handler:
 
 _irq128Handler:
 	pushState
-    call [syscalls + rax * 8] ; llamamos a la syscall
-    mov [aux], rax ; preservamos el valor de retorno de la syscall
-    popState
-    mov rax, [aux]
-    iretq
+	call kernel_lock
+	call scheduler_syscall_entry
+
+	; kernel_lock pisa los registros: recuperar número de syscall y argumentos del contexto
+	mov rax, [rsp]
+	mov rdi, [rsp + 8*10]
+	mov rsi, [rsp + 8*9]
+	mov rdx, [rsp + 8*12]
+	mov rcx, [rsp + 8*13]
+	mov r8,  [rsp + 8*8]
+	mov r9,  [rsp + 8*7]
+	call [syscalls + rax * 8] ; llamamos a la syscall
+
+	mov [rsp], rax ; el valor de retorno queda en el rax que restaura popState
+	call kernel_unlock
+	popState
+	iretq
+
+;Local APIC Timer (APs)
+_lapicTimerHandler:
+	lapicHandler LAPIC_TIMER_VECTOR
+
+;IPI de reschedule entre CPUs
+_reschedHandler:
+	lapicHandler RESCHED_VECTOR
+
+; IPI de arranque de un AP: cambia al stack de kernel que le preparó el BSP y entra al kernel.
+; smp_ap_main no retorna.
+_apStartHandler:
+	call smp_ap_stack_top
+	test rax, rax
+	jz .park
+	mov rsp, rax
+	call smp_ap_main
+.park:
+	cli
+	hlt
+	jmp .park
+
+; Interrupción espuria del LAPIC: no se confirma con EOI
+_spuriousHandler:
+	iretq
 
 
 
@@ -232,14 +317,45 @@ setup_initial_stack:
 	push rdi           ; 7) Empuja RIP = caller
 	mov rdi, rsi       ; 8) Prepara 1er arg para caller: rdi = pid
 	pushState          ; 10) Simula registros salvados por ISR
-	mov rax, rsp       ; 11) Devuelve a C el RSP armado
-	mov rsp, r8        ; 12) Restaura pila original del llamador
+	mov rax, process_start
+	push rax           ; 11) Marco de context_switch: retorna a process_start
+	push 0x0           ;     con rbx, rbp, r12-r15 en 0
+	push 0x0
+	push 0x0
+	push 0x0
+	push 0x0
+	push 0x0
+	mov rax, rsp       ; 12) Devuelve a C el RSP armado
+	mov rsp, r8        ; 13) Restaura pila original del llamador
 	mov rbp, r9
-	ret                ; 13) Retorna a C con rax = nuevo RSP
+	ret                ; 14) Retorna a C con rax = nuevo RSP
 
+; Primera vez que corre un proceso: context_switch retorna acá con el lock del kernel tomado,
+; sobre el marco de interrupción que armó setup_initial_stack
+process_start:
+	call kernel_unlock
+	popState
+	iretq
 
-timer_tick: 
-	int 20h
+; rdi = dónde guardar el RSP del contexto actual, rsi = RSP del contexto a retomar.
+; Solo guarda los registros que la convención de llamadas obliga a preservar: los demás ya los
+; guardó el llamador (o el handler de la interrupción que llamó al scheduler). Se llama con
+; interrupciones deshabilitadas y el lock del kernel tomado.
+context_switch:
+	push rbx
+	push rbp
+	push r12
+	push r13
+	push r14
+	push r15
+	mov [rdi], rsp
+	mov rsp, rsi
+	pop r15
+	pop r14
+	pop r13
+	pop r12
+	pop rbp
+	pop rbx
 	ret
 
 
@@ -252,6 +368,16 @@ _exception0Handler:
 _exception6Handler: 
 	exceptionHandler 6
 
+; Device Not Available (#NM): primera instrucción x87/SSE/AVX con CR0.TS prendido. No es un error:
+; se cargan los registros del proceso y se reintenta la instrucción
+_exception7Handler:
+	pushState
+	call kernel_lock
+	call fpu_handle_nm
+	call kernel_unlock
+	popState
+	iretq
+
 haltcpu:
 	cli
 	hlt
@@ -259,9 +385,10 @@ haltcpu:
 
 SECTION .data 
 	userland equ 0x400000 
+	LAPIC_TIMER_VECTOR equ 0x40
+	RESCHED_VECTOR equ 0x41
 
 SECTION .bss
-	aux resq 1
 	pressed_key resq 1
 	reg_array resq 20 ; 20 registros
 	syscall_frame_ptr resq 1
@@ -11,6 +11,22 @@ GLOBAL get_seconds
 GLOBAL get_minutes
 GLOBAL get_hour
 GLOBAL set_timer_freq
+GLOBAL read_tsc
+GLOBAL write_msr
+GLOBAL get_cpu_local
+GLOBAL cpu_relax
+GLOBAL cpuid_query
+GLOBAL read_cr0
+GLOBAL write_cr0
+GLOBAL read_cr4
+GLOBAL write_cr4
+GLOBAL write_xcr0
+GLOBAL fpu_clts
+GLOBAL fpu_fninit
+GLOBAL fpu_fxsave
+GLOBAL fpu_fxrstor
+GLOBAL fpu_xsave
+GLOBAL fpu_xrstor
 
 extern store_snapshot
 
@@ -57,6 +73,105 @@ set_timer_freq:
     pop rbp
     ret
 
+; Devuelve el Time Stamp Counter (contador de ciclos) de 64 bits
+read_tsc:
+	rdtsc
+	shl rdx, 32
+	or rax, rdx
+	ret
+
+; void write_msr(uint32_t msr, uint64_t value)
+write_msr:
+	mov ecx, edi
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	wrmsr
+	ret
+
+; Devuelve el puntero a los datos de la CPU actual: el primer campo de cpu_t apunta a sí mismo
+; y GS base apunta a la estructura de cada CPU (ver smp.c)
+get_cpu_local:
+	mov rax, [gs:0]
+	ret
+
+; Hint para loops de espera activa (reduce el consumo y la penalidad al salir del spin)
+cpu_relax:
+	pause
+	ret
+
+; void cpuid_query(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]): regs = {eax, ebx, ecx, edx}
+cpuid_query:
+	push rbx
+	mov r8, rdx
+	mov eax, edi
+	mov ecx, esi
+	cpuid
+	mov [r8], eax
+	mov [r8 + 4], ebx
+	mov [r8 + 8], ecx
+	mov [r8 + 12], edx
+	pop rbx
+	ret
+
+read_cr0:
+	mov rax, cr0
+	ret
+
+write_cr0:
+	mov cr0, rdi
+	ret
+
+read_cr4:
+	mov rax, cr4
+	ret
+
+write_cr4:
+	mov cr4, rdi
+	ret
+
+; void write_xcr0(uint64_t value): componentes que maneja XSAVE (necesita CR4.OSXSAVE)
+write_xcr0:
+	mov eax, edi
+	mov rdx, rdi
+	shr rdx, 32
+	xor ecx, ecx
+	xsetbv
+	ret
+
+; Apaga CR0.TS: la próxima instrucción x87/SSE/AVX no genera #NM
+fpu_clts:
+	clts
+	ret
+
+fpu_fninit:
+	fninit
+	ret
+
+; void fpu_fxsave(void *area) / fpu_fxrstor(void *area): área de 512 bytes alineada a 16
+fpu_fxsave:
+	fxsave64 [rdi]
+	ret
+
+fpu_fxrstor:
+	fxrstor64 [rdi]
+	ret
+
+; void fpu_xsave(void *area, uint64_t mask) / fpu_xrstor(...): área alineada a 64
+fpu_xsave:
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	xsave64 [rdi]
+	ret
+
+fpu_xrstor:
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	xrstor64 [rdi]
+	ret
+
 get_seconds:
 	mov al, 0
 	out 0x70, al
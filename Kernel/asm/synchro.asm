@@ -2,18 +2,56 @@
 
 GLOBAL acquire_lock
 GLOBAL release_lock
+GLOBAL acquire_lock_irqsave
+GLOBAL release_lock_irqrestore
 
 section .text
 ; void acquire(lock_t *lock)
+; Test-and-test-and-set: mientras el lock está tomado se lo lee sin escribir, así la línea de
+; cache no rebota entre las CPUs que esperan
 acquire_lock:
-    mov al, 0
 .retry:
+    mov al, 0
     xchg [rdi], al
     test al, al
-    jz .retry
+    jnz .acquired
+.spin:
+    pause
+    cmp byte [rdi], 0
+    je .spin
+    jmp .retry
+.acquired:
     ret
 
 ; void release(lock_t *lock)
 release_lock:
     mov byte [rdi], 1
-    ret
\ No newline at end of file
+    ret
+
+; uint64_t acquire_lock_irqsave(lock_t *lock)
+; Deshabilita interrupciones antes de tomar el lock y devuelve los RFLAGS anteriores, para que
+; una interrupción en la misma CPU no intente tomar un lock que ya tiene
+acquire_lock_irqsave:
+    pushfq
+    pop rdx
+    cli
+.retry:
+    mov al, 0
+    xchg [rdi], al
+    test al, al
+    jnz .acquired
+.spin:
+    pause
+    cmp byte [rdi], 0
+    je .spin
+    jmp .retry
+.acquired:
+    mov rax, rdx
+    ret
+
+; void release_lock_irqrestore(lock_t *lock, uint64_t flags)
+release_lock_irqrestore:
+    mov byte [rdi], 1
+    push rsi
+    popfq
+    ret
@@ -0,0 +1,129 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "apic.h"
+
+// Dirección del Local APIC guardada por Pure64 en el InfoMap
+#define INFOMAP_LAPIC_ADDRESS ((uint64_t *)0x5060)
+
+// Registros del Local APIC (offsets desde la base)
+#define LAPIC_ID 0x020
+#define LAPIC_EOI 0x0B0
+#define LAPIC_ICR_LOW 0x300
+#define LAPIC_ICR_HIGH 0x310
+#define LAPIC_LVT_TIMER 0x320
+#define LAPIC_TIMER_INITIAL 0x380
+#define LAPIC_TIMER_CURRENT 0x390
+#define LAPIC_TIMER_DIVIDE 0x3E0
+
+#define ICR_DELIVERY_PENDING (1 << 12)
+#define ICR_LEVEL_ASSERT (1 << 14)
+#define LVT_MASKED (1 << 16)
+#define LVT_TIMER_PERIODIC (1 << 17)
+#define TIMER_DIVIDE_BY_16 0x3
+
+// Canal 2 del PIT, usado como referencia para calibrar
+#define PIT_FREQUENCY 1193182
+#define PIT_CONTROL_PORT 0x43
+#define PIT_CHANNEL2_DATA_PORT 0x42
+#define PIT_CHANNEL2_ONESHOT 0xB0 // canal 2, lobyte/hibyte, modo 0 (interrupt on terminal count)
+#define PC_SPEAKER_PORT 0x61
+#define PIT_CHANNEL2_GATE 0x01
+#define PC_SPEAKER_DATA 0x02
+#define PIT_CHANNEL2_OUT 0x20
+#define CALIBRATION_HZ 100 // se mide durante 10 ms
+
+extern uint8_t port_reader(uint16_t port);
+extern void    port_writer(uint16_t port, uint8_t data);
+
+static volatile uint32_t *lapic_base = 0;
+
+static inline uint32_t lapic_read(uint32_t reg)
+{
+	return lapic_base[reg / sizeof(uint32_t)];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value)
+{
+	lapic_base[reg / sizeof(uint32_t)] = value;
+}
+
+bool lapic_init(void)
+{
+	lapic_base = (volatile uint32_t *)*INFOMAP_LAPIC_ADDRESS;
+	return lapic_base != 0;
+}
+
+bool lapic_present(void)
+{
+	return lapic_base != 0;
+}
+
+uint8_t lapic_id(void)
+{
+	return lapic_read(LAPIC_ID) >> 24;
+}
+
+void lapic_eoi(void)
+{
+	lapic_write(LAPIC_EOI, 0);
+}
+
+void lapic_send_ipi(uint8_t apic_id, uint8_t vector)
+{
+	// Esperar a que termine de entregarse la IPI anterior antes de pisar el ICR
+	while (lapic_read(LAPIC_ICR_LOW) & ICR_DELIVERY_PENDING)
+		;
+
+	lapic_write(LAPIC_ICR_HIGH, (uint32_t)apic_id << 24);
+	lapic_write(LAPIC_ICR_LOW, ICR_LEVEL_ASSERT | vector); // escribir la parte baja la envía
+}
+
+uint32_t lapic_timer_calibrate(uint32_t hz)
+{
+	uint16_t pit_count = PIT_FREQUENCY / CALIBRATION_HZ;
+	uint8_t  speaker   = port_reader(PC_SPEAKER_PORT);
+
+	// Habilitar el gate del canal 2 con el parlante desconectado
+	port_writer(PC_SPEAKER_PORT, (speaker & ~PC_SPEAKER_DATA) | PIT_CHANNEL2_GATE);
+	port_writer(PIT_CONTROL_PORT, PIT_CHANNEL2_ONESHOT);
+
+	lapic_write(LAPIC_TIMER_DIVIDE, TIMER_DIVIDE_BY_16);
+	lapic_write(LAPIC_LVT_TIMER, LVT_MASKED);
+
+	// El canal 2 empieza a contar al recibir el byte alto; el timer del LAPIC al escribir la
+	// cuenta inicial
+	port_writer(PIT_CHANNEL2_DATA_PORT, pit_count & 0xFF);
+	port_writer(PIT_CHANNEL2_DATA_PORT, pit_count >> 8);
+	lapic_write(LAPIC_TIMER_INITIAL, 0xFFFFFFFF);
+
+	// En modo 0 la salida del canal 2 pasa a 1 al llegar a cero
+	while ((port_reader(PC_SPEAKER_PORT) & PIT_CHANNEL2_OUT) == 0)
+		;
+
+	uint32_t elapsed = 0xFFFFFFFF - lapic_read(LAPIC_TIMER_CURRENT);
+	lapic_write(LAPIC_TIMER_INITIAL, 0);
+	port_writer(PC_SPEAKER_PORT, speaker);
+
+	return (uint32_t)((uint64_t)elapsed * CALIBRATION_HZ / hz);
+}
+
+void lapic_timer_start(uint32_t initial_count, uint8_t vector)
+{
+	lapic_write(LAPIC_TIMER_DIVIDE, TIMER_DIVIDE_BY_16);
+	lapic_write(LAPIC_LVT_TIMER, LVT_TIMER_PERIODIC | vector);
+	lapic_write(LAPIC_TIMER_INITIAL, initial_count);
+}
+
+void lapic_timer_oneshot(uint32_t count, uint8_t vector)
+{
+	lapic_write(LAPIC_TIMER_DIVIDE, TIMER_DIVIDE_BY_16);
+	lapic_write(LAPIC_LVT_TIMER, vector); // modo one-shot
+	lapic_write(LAPIC_TIMER_INITIAL, count);
+}
+
+void lapic_timer_stop(void)
+{
+	lapic_write(LAPIC_LVT_TIMER, LVT_MASKED);
+	lapic_write(LAPIC_TIMER_INITIAL, 0); // cuenta inicial 0 detiene el timer
+}
@@ -0,0 +1,220 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "fpu.h"
+#include "lib.h"
+#include "memory_manager.h"
+#include "scheduler.h"
+#include <stddef.h>
+
+#define CR0_MP (1ull << 1)
+#define CR0_EM (1ull << 2)
+#define CR0_TS (1ull << 3)
+#define CR0_NE (1ull << 5)
+
+#define CR4_OSFXSR (1ull << 9)
+#define CR4_OSXMMEXCPT (1ull << 10)
+#define CR4_OSXSAVE (1ull << 18)
+
+#define CPUID_1_ECX_XSAVE (1u << 26)
+#define CPUID_1_ECX_AVX (1u << 28)
+
+#define XCR0_X87 (1ull << 0)
+#define XCR0_SSE (1ull << 1)
+#define XCR0_AVX (1ull << 2)
+
+#define FXSAVE_SIZE 512
+#define STATE_ALIGN 64 // XSAVE pide 64, FXSAVE 16
+
+extern void     cpuid_query(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]);
+extern uint64_t read_cr0(void);
+extern void     write_cr0(uint64_t value);
+extern uint64_t read_cr4(void);
+extern void     write_cr4(uint64_t value);
+extern void     write_xcr0(uint64_t value);
+extern void     fpu_clts(void);
+extern void     fpu_fninit(void);
+extern void     fpu_fxsave(void *area);
+extern void     fpu_fxrstor(void *area);
+extern void     fpu_xsave(void *area, uint64_t mask);
+extern void     fpu_xrstor(void *area, uint64_t mask);
+
+static bool     detected   = false;
+static bool     use_xsave  = false;
+static uint64_t xsave_mask = XCR0_X87 | XCR0_SSE;
+static uint32_t state_size = FXSAVE_SIZE;
+static uint64_t traps      = 0;
+
+// Estado de un proceso que todavía no usó SSE (FPU recién inicializada, MXCSR por defecto)
+static uint8_t initial_state[FPU_MAX_STATE_SIZE] __attribute__((aligned(STATE_ALIGN)));
+
+static inline void set_ts(void)
+{
+	write_cr0(read_cr0() | CR0_TS);
+}
+
+static void save_state(void *area)
+{
+	if (use_xsave) {
+		fpu_xsave(area, xsave_mask);
+	} else {
+		fpu_fxsave(area);
+	}
+}
+
+static void restore_state(void *area)
+{
+	if (use_xsave) {
+		fpu_xrstor(area, xsave_mask);
+	} else {
+		fpu_fxrstor(area);
+	}
+}
+
+static void detect_features(void)
+{
+	uint32_t regs[4];
+	cpuid_query(1, 0, regs);
+
+	if (regs[2] & CPUID_1_ECX_XSAVE) {
+		use_xsave = true;
+		if (regs[2] & CPUID_1_ECX_AVX) {
+			xsave_mask |= XCR0_AVX;
+		}
+	}
+	detected = true;
+}
+
+// Con XCR0 ya configurado, CPUID 0xD informa el tamaño del área para esos componentes
+static void measure_state_size(void)
+{
+	uint32_t regs[4];
+	cpuid_query(0xD, 0, regs);
+	if (regs[1] > FPU_MAX_STATE_SIZE) {
+		// No debería pasar con solo x87/SSE/AVX habilitados: volver a FXSAVE
+		use_xsave  = false;
+		xsave_mask = XCR0_X87 | XCR0_SSE;
+		write_cr4(read_cr4() & ~CR4_OSXSAVE);
+		return;
+	}
+	state_size = regs[1];
+}
+
+void fpu_init_cpu(void)
+{
+	bool first = !detected;
+	if (first) {
+		detect_features();
+	}
+
+	write_cr0((read_cr0() & ~CR0_EM) | CR0_MP | CR0_NE);
+	uint64_t cr4 = read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT;
+	if (use_xsave) {
+		cr4 |= CR4_OSXSAVE;
+	}
+	write_cr4(cr4);
+	if (use_xsave) {
+		write_xcr0(xsave_mask);
+	}
+
+	if (first) {
+		if (use_xsave) {
+			measure_state_size();
+		}
+		fpu_clts();
+		fpu_fninit();
+		save_state(initial_state);
+	}
+
+	cpu_t *cpu     = this_cpu();
+	cpu->fpu_owner = NULL;
+	cpu->fpu_live  = false;
+	set_ts();
+}
+
+void fpu_switch(cpu_t *cpu, PCB *prev, PCB *next)
+{
+	if (prev != NULL && cpu->fpu_live) {
+		if (prev->status == PS_TERMINATED) {
+			// No va a volver a correr: no hace falta guardar nada
+			if (cpu->fpu_owner == prev) {
+				cpu->fpu_owner = NULL;
+			}
+		} else {
+			save_state(prev->fpu_state);
+			cpu->fpu_owner = prev;
+			prev->fpu_cpu  = cpu->id;
+		}
+	}
+
+	// Si nadie cargó otro estado en esta CPU desde que next la dejó, sus registros siguen ahí
+	if (next != NULL && cpu->fpu_owner == next && next->fpu_cpu == cpu->id) {
+		fpu_clts();
+		cpu->fpu_live = true;
+	} else {
+		set_ts();
+		cpu->fpu_live = false;
+	}
+}
+
+// El área se aloca en el primer uso, alineada a mano (el memory manager no garantiza 64 bytes)
+static bool alloc_state(PCB *p)
+{
+	void *raw = alloc_memory(get_kernel_memory_manager(), state_size + STATE_ALIGN - 1);
+	if (raw == NULL) {
+		return false;
+	}
+	p->fpu_alloc = raw;
+	p->fpu_state = (void *)(((uint64_t)raw + STATE_ALIGN - 1) & ~(uint64_t)(STATE_ALIGN - 1));
+	memcpy(p->fpu_state, initial_state, state_size);
+	return true;
+}
+
+void fpu_handle_nm(void)
+{
+	cpu_t *cpu     = this_cpu();
+	PCB   *current = cpu->current;
+
+	traps++;
+	fpu_clts();
+	cpu->fpu_live = true;
+
+	if (current == NULL || (cpu->fpu_owner == current && current->fpu_cpu == cpu->id)) {
+		return;
+	}
+
+	if (current->fpu_state == NULL && !alloc_state(current)) {
+		// Sin memoria para guardar sus registros no puede seguir corriendo. Si no se lo puede
+		// matar (init o la shell), sigue pero sin que se guarden sus registros. Como va a
+		// pisar los del dueño anterior (fpu_switch los guardó al sacarlo), la CPU deja de
+		// tenerlos: cuando el dueño vuelva a correr los restaura su propio #NM.
+		cpu->fpu_owner = NULL;
+		cpu->fpu_live  = false;
+		scheduler_kill_process(current->pid);
+		return;
+	}
+
+	restore_state(current->fpu_state);
+	cpu->fpu_owner   = current;
+	current->fpu_cpu = cpu->id;
+}
+
+void fpu_release(PCB *p)
+{
+	for (int i = 0; i < smp_cpu_count(); i++) {
+		cpu_t *cpu = smp_get_cpu(i);
+		if (cpu->fpu_owner == p) {
+			cpu->fpu_owner = NULL;
+		}
+	}
+	if (p->fpu_alloc != NULL) {
+		free_memory(get_kernel_memory_manager(), p->fpu_alloc);
+		p->fpu_alloc = NULL;
+		p->fpu_state = NULL;
+	}
+}
+
+uint64_t fpu_trap_count(void)
+{
+	return traps;
+}
@@ -90,11 +90,13 @@ uint8_t get_char_from_buffer() {
 // (comportamiento idéntico a pipes)
 uint64_t read_keyboard_buffer(char *buff_copy, uint64_t count) {
 
+  scheduler_set_io_wait(true); // al despertarlo con una tecla se lo promueve
   for (int i = 0; i < count; i++) {
     sem_wait(
         KEYBOARD_SEM_NAME); // Bloquea hasta que haya un carácter disponible
     buff_copy[i] = get_char_from_buffer();
   }
+  scheduler_set_io_wait(false);
   return count;
 }
 
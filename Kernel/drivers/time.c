@@ -5,6 +5,37 @@
 #include "time.h"
 #include "scheduler.h"
 #include "video_driver.h"
+#include "smp.h"
+#include "apic.h"
+#include "interrupts.h"
+#include <stddef.h>
+
+// Tickless idle: cuando el BSP no tiene nada para correr se enmascara el IRQ del PIT y el tiempo
+// transcurrido se calcula con el TSC
+#define PIC_MASK_TICK_ON 0xFC  // timer y teclado habilitados
+#define PIC_MASK_TICK_OFF 0xFD // solo teclado
+#define PIC_MASTER_COMMAND 0x20
+#define PIC_READ_IRR 0x0A
+#define PIT_IRQ_BIT 0x01
+#define TSC_CALIBRATION_TICKS 5
+#define MAX_ONESHOT_TICKS 1000 // el one-shot despierta al menos cada 10 s y se reprograma
+
+// Rueda de timers: un proceso dormido se cuelga del slot wake_tick % TIMER_WHEEL_SIZE y cada tick
+// solo revisa su slot
+#define TIMER_WHEEL_SIZE 64
+#define NO_DEADLINE ((uint64_t)-1)
+
+// Reloj de alta resolución y RTC cacheado
+#define NS_PER_TICK 10000000ULL // 100 Hz
+#define NS_PER_MS 1000000ULL
+#define NS_PER_SECOND 1000000000ULL
+#define SECONDS_PER_DAY 86400
+#define RTC_RESYNC_SECONDS 3600 // releer el CMOS cada hora para acotar el drift del TSC
+
+extern uint64_t read_tsc(void);
+extern uint8_t  port_reader(uint16_t port);
+extern void     port_writer(uint16_t port, uint8_t data);
+extern void     cpu_relax(void);
 
 extern uint8_t get_hour();
 extern uint8_t get_minutes();
@@ -13,36 +44,341 @@ uint8_t get_day();
 uint8_t get_month();
 uint8_t get_year();
 
-static uint64_t ticks = 0;
+static volatile uint64_t ticks = 0;
+static uint64_t tick_tsc = 0;       // TSC en el último tick contado
+static uint64_t tsc_per_tick = 0;   // 0 = sin calibrar: el BSP nunca apaga el tick
+static bool skip_pending_tick = false;
+static uint64_t boot_tsc = 0; // origen de clock_ns()
+
+static uint8_t rtc_date[3];       // dd/mm/yy en BCD, como los devuelve el CMOS
+static uint32_t rtc_base_seconds; // hora del día (en segundos) al leer el CMOS
+static uint64_t rtc_base_ns;      // clock_ns() al leer el CMOS
+static bool rtc_cached = false;
+
+static PCB *timer_wheel[TIMER_WHEEL_SIZE];
+static uint32_t sleeping_count = 0;
+static uint64_t expired_until = 0; // último tick cuyos timers ya se procesaron
+
+static void timer_add(PCB *p, uint64_t wake_tick) {
+  PCB **slot = &timer_wheel[wake_tick % TIMER_WHEEL_SIZE];
+
+  p->wake_tick = wake_tick;
+  p->timer_prev = NULL;
+  p->timer_next = *slot;
+  if (*slot != NULL) {
+    (*slot)->timer_prev = p;
+  }
+  *slot = p;
+  p->on_timer = true;
+  sleeping_count++;
+}
+
+static void timer_remove(PCB *p) {
+  if (!p->on_timer) {
+    return;
+  }
+
+  if (p->timer_prev != NULL) {
+    p->timer_prev->timer_next = p->timer_next;
+  } else {
+    timer_wheel[p->wake_tick % TIMER_WHEEL_SIZE] = p->timer_next;
+  }
+  if (p->timer_next != NULL) {
+    p->timer_next->timer_prev = p->timer_prev;
+  }
+  p->timer_next = NULL;
+  p->timer_prev = NULL;
+  p->on_timer = false;
+  sleeping_count--;
+}
+
+// Despierta a los procesos del slot cuyo deadline ya pasó (en el slot también hay procesos que
+// duermen vueltas enteras más de la rueda)
+static void expire_slot(uint32_t slot, uint64_t now) {
+  PCB *p = timer_wheel[slot];
+  while (p != NULL) {
+    PCB *next = p->timer_next;
+    if (p->wake_tick <= now) {
+      timer_remove(p);
+      scheduler_unblock_process(p->pid);
+    }
+    p = next;
+  }
+}
+
+// Procesa los timers de los ticks (expired_until, now]. Después de un período tickless largo
+// alcanza con revisar cada slot una vez.
+static void expire_timers(uint64_t now) {
+  if (sleeping_count > 0) {
+    uint64_t from = expired_until + 1;
+    if (now - expired_until > TIMER_WHEEL_SIZE) {
+      from = now - TIMER_WHEEL_SIZE + 1;
+    }
+    for (uint64_t t = from; t <= now; t++) {
+      expire_slot(t % TIMER_WHEEL_SIZE, now);
+    }
+  }
+  expired_until = now;
+}
 
-uint64_t timer_handler(uint64_t rsp) {
+static uint64_t next_deadline() {
+  uint64_t deadline = NO_DEADLINE;
+  if (sleeping_count == 0) {
+    return deadline;
+  }
+  for (int i = 0; i < TIMER_WHEEL_SIZE; i++) {
+    for (PCB *p = timer_wheel[i]; p != NULL; p = p->timer_next) {
+      if (p->wake_tick < deadline) {
+        deadline = p->wake_tick;
+      }
+    }
+  }
+  return deadline;
+}
+
+void timer_handler() {
+  if (skip_pending_tick) {
+    // IRQ que quedó pendiente mientras el PIT estaba enmascarado: ya se contó al reanudar
+    skip_pending_tick = false;
+    return;
+  }
   ticks++;
-  rsp = (uint64_t)schedule((void *)rsp);
-  return rsp;
+  tick_tsc = read_tsc();
+  expire_timers(ticks);
+  schedule();
+}
+
+void timer_deadline_handler() {
+  // El BSP estaba en idle con el PIT enmascarado y llegó el deadline de un proceso dormido:
+  // al reanudar el tick se cuentan los ticks perdidos y se despierta a los que vencieron
+  tick_restart();
+  schedule();
+}
+
+// Ticks completos que pasaron desde el último tick contado con el PIT enmascarado
+static uint64_t missed_ticks() { return (read_tsc() - tick_tsc) / tsc_per_tick; }
+
+uint64_t ticks_elapsed() {
+  if (smp_get_cpu(BSP_CPU)->tick_stopped) {
+    return ticks + missed_ticks();
+  }
+  return ticks;
 }
 
-uint64_t ticks_elapsed() { return ticks; }
+int seconds_elapsed() { return ticks_elapsed() / 100; }
 
-int seconds_elapsed() { return ticks / 100; }
+void timer_calibrate_tsc() {
+  // Esperar un flanco del PIT y medir cuántos ciclos entran en TSC_CALIBRATION_TICKS ticks
+  uint64_t start = ticks;
+  while (ticks == start) {
+    cpu_relax();
+  }
+  uint64_t tsc_start = read_tsc();
+  start = ticks;
+  while (ticks - start < TSC_CALIBRATION_TICKS) {
+    cpu_relax();
+  }
+  tsc_per_tick = (read_tsc() - tsc_start) / TSC_CALIBRATION_TICKS;
+  boot_tsc = tsc_start;
+}
+
+// Conversiones partidas en ticks enteros + resto para no desbordar 64 bits
+static uint64_t tsc_to_ns(uint64_t tsc) {
+  return tsc / tsc_per_tick * NS_PER_TICK + tsc % tsc_per_tick * NS_PER_TICK / tsc_per_tick;
+}
+
+static uint64_t ns_to_tsc(uint64_t ns) {
+  return ns / NS_PER_TICK * tsc_per_tick + ns % NS_PER_TICK * tsc_per_tick / NS_PER_TICK;
+}
+
+uint64_t clock_ns() {
+  if (tsc_per_tick == 0) {
+    return ticks * NS_PER_TICK;
+  }
+  return tsc_to_ns(read_tsc() - boot_tsc);
+}
 
-void sleep(int miliseconds) { // normaliza a 10 ms
-  unsigned long start_ticks = ticks;
-  unsigned long target_ticks =
-      miliseconds / 10; // convertir ms a ticks (100 ticks/seg)
+// Programa el timer del LAPIC del BSP en one-shot para el flanco del PIT en el que vence el
+// próximo proceso dormido. Devuelve false si hay procesos dormidos pero no hay LAPIC para
+// despertarlos: en ese caso el PIT tiene que seguir periódico.
+static bool arm_deadline() {
+  uint64_t deadline = next_deadline();
+  if (deadline == NO_DEADLINE) {
+    if (lapic_present()) {
+      lapic_timer_stop();
+    }
+    return true;
+  }
+  if (!lapic_present() || smp_timer_count() == 0) {
+    return false;
+  }
+
+  // El PIT sigue en fase con tick_tsc aunque esté enmascarado
+  uint64_t delta = deadline > ticks ? deadline - ticks : 0;
+  if (delta > MAX_ONESHOT_TICKS) {
+    delta = MAX_ONESHOT_TICKS;
+  }
+  uint64_t target_tsc = delta * tsc_per_tick;
+  uint64_t elapsed_tsc = read_tsc() - tick_tsc;
+  uint64_t remaining_tsc = target_tsc > elapsed_tsc ? target_tsc - elapsed_tsc : 0;
+
+  lapic_timer_oneshot(remaining_tsc * smp_timer_count() / tsc_per_tick + 1,
+                      LAPIC_TIMER_VECTOR);
+  return true;
+}
+
+void tick_stop() {
+  cpu_t *cpu = this_cpu();
+  if (cpu->tick_stopped) {
+    return;
+  }
+
+  if (cpu->id == BSP_CPU) {
+    if (tsc_per_tick == 0 || !arm_deadline()) {
+      return;
+    }
+    picMasterMask(PIC_MASK_TICK_OFF);
+  } else {
+    lapic_timer_stop();
+  }
+  cpu->tick_stopped = true;
+}
+
+void tick_restart() {
+  cpu_t *cpu = this_cpu();
+  if (!cpu->tick_stopped) {
+    return;
+  }
+
+  if (cpu->id == BSP_CPU) {
+    if (lapic_present()) {
+      lapic_timer_stop(); // cancelar el one-shot si se despertó antes por otra razón
+    }
+
+    // El PIT siguió contando en fase: si hubo al menos un flanco mientras estuvo
+    // enmascarado, el PIC lo tiene pendiente y se entrega apenas se desenmascara
+    port_writer(PIC_MASTER_COMMAND, PIC_READ_IRR);
+    if (port_reader(PIC_MASTER_COMMAND) & PIT_IRQ_BIT) {
+      uint64_t missed = missed_ticks();
+      if (missed == 0) {
+        missed = 1;
+      }
+      ticks += missed;
+      tick_tsc += missed * tsc_per_tick;
+      skip_pending_tick = true;
+    }
+    cpu->tick_stopped = false;
+    picMasterMask(PIC_MASK_TICK_ON);
+
+    // Con el tick ya prendido: despertar a un proceso puede volver a llamar a tick_restart()
+    expire_timers(ticks);
+  } else {
+    cpu->tick_stopped = false;
+    lapic_timer_start(smp_timer_count(), LAPIC_TIMER_VECTOR);
+  }
+}
+
+void tick_rearm() {
+  cpu_t *cpu = this_cpu();
+  if (cpu->id == BSP_CPU && cpu->tick_stopped && !arm_deadline()) {
+    tick_restart();
+  }
+}
+
+// El proceso queda BLOCKED en la rueda hasta su deadline: no consume quantums mientras duerme.
+// Si alguien lo desbloquea antes (sys_unblock), vuelve a dormir lo que le falta.
+static void sleep_until_tick(PCB *current, uint64_t wake_tick) {
+  while (ticks_elapsed() < wake_tick) {
+    timer_add(current, wake_tick);
+    if (this_cpu()->id != BSP_CPU && smp_get_cpu(BSP_CPU)->tick_stopped) {
+      smp_send_resched(BSP_CPU); // que el BSP reprograme su one-shot con este deadline
+    }
+    scheduler_block_process(current->pid);
+    timer_remove(current); // no hace nada si ya lo sacó el tick
+  }
+}
+
+void sleep(int miliseconds) { // normaliza a 10 ms, redondeando para arriba
+  uint64_t target_ticks =
+      (miliseconds + 9) / 10; // convertir ms a ticks (100 ticks/seg)
+  uint64_t wake_tick = ticks_elapsed() + target_ticks;
+  PCB *current = this_cpu()->current;
+
+  if (current == NULL) {
+    // Antes de que arranque el scheduler no hay proceso para bloquear
+    while (ticks_elapsed() < wake_tick) {
+      kernel_wait_for_interrupt(); // suelta el lock del kernel: ticks lo avanza el BSP
+    }
+    return;
+  }
+
+  sleep_until_tick(current, wake_tick);
+}
+
+void nanosleep(uint64_t nanoseconds) {
+  PCB *current = this_cpu()->current;
+  if (tsc_per_tick == 0 || current == NULL) {
+    sleep(nanoseconds / NS_PER_MS);
+    return;
+  }
+
+  uint64_t deadline_tsc = read_tsc() + ns_to_tsc(nanoseconds);
+
+  // Los ticks enteros se duermen bloqueado en la rueda, hasta el último flanco del PIT antes
+  // del deadline (el PIT sigue en fase con tick_tsc aunque esté enmascarado)
+  if (deadline_tsc > tick_tsc) {
+    sleep_until_tick(current, ticks + (deadline_tsc - tick_tsc) / tsc_per_tick);
+  }
+
+  // El resto (menos de un tick) se espera activamente contra el TSC, sin el lock del kernel y
+  // con interrupciones habilitadas para poder ser desalojado
+  uint32_t depth = kernel_unlock_all();
+  _sti();
+  while (read_tsc() < deadline_tsc) {
+    cpu_relax();
+  }
+  _cli();
+  kernel_relock(depth);
+}
+
+void sleep_cancel(PCB *p) { timer_remove(p); }
+
+static uint8_t bcd_to_bin(uint8_t value) { return (value >> 4) * 10 + (value & 0x0F); }
+
+static uint8_t bin_to_bcd(uint8_t value) { return ((value / 10) << 4) | (value % 10); }
+
+static void rtc_sync() {
+  rtc_base_seconds = bcd_to_bin(get_hour()) * 3600 + bcd_to_bin(get_minutes()) * 60 +
+                     bcd_to_bin(get_seconds());
+  rtc_date[0] = get_day();
+  rtc_date[1] = get_month();
+  rtc_date[2] = get_year();
+  rtc_base_ns = clock_ns();
+  rtc_cached = true;
+}
 
-  while ((ticks - start_ticks) < target_ticks) {
-    _hlt();
+// Segundos desde la medianoche: hora leída del CMOS más lo que avanzó el TSC desde entonces.
+// Se vuelve a leer el CMOS al pasar la medianoche (cambia la fecha) o cada RTC_RESYNC_SECONDS.
+static uint32_t rtc_seconds_of_day() {
+  uint64_t elapsed = rtc_cached ? (clock_ns() - rtc_base_ns) / NS_PER_SECOND : 0;
+  if (!rtc_cached || tsc_per_tick == 0 || elapsed >= RTC_RESYNC_SECONDS ||
+      rtc_base_seconds + elapsed >= SECONDS_PER_DAY) {
+    rtc_sync();
+    elapsed = 0;
   }
+  return rtc_base_seconds + elapsed;
 }
 
 void get_date(uint8_t *buffer) {
-  buffer[0] = get_day();
-  buffer[1] = get_month();
-  buffer[2] = get_year();
+  rtc_seconds_of_day(); // resincroniza la fecha si pasó la medianoche
+  buffer[0] = rtc_date[0];
+  buffer[1] = rtc_date[1];
+  buffer[2] = rtc_date[2];
 }
 
 void get_time(uint8_t *buffer) {
-  buffer[0] = get_hour();
-  buffer[1] = get_minutes();
-  buffer[2] = get_seconds();
+  uint32_t seconds = rtc_seconds_of_day();
+  buffer[0] = bin_to_bcd(seconds / 3600);
+  buffer[1] = bin_to_bcd(seconds / 60 % 60);
+  buffer[2] = bin_to_bcd(seconds % 60);
 }
@@ -4,12 +4,12 @@
 #include "exceptions.h"
 #include "keyboard.h"
 #include "video_driver.h"
+#include "smp.h"
 
 static void zero_division();
 static void invalid_opcode();
 static void excep_handler(char *msg);
 extern void return_to_userland();
-extern void _hlt();
 extern void _sti();
 
 static Exception exceptions[] = {&zero_division, 0, 0, 0, 0, 0, &invalid_opcode};
@@ -31,7 +31,7 @@ static void excep_handler(char *msg)
 	int c;
 	_sti();
 	do {
-		_hlt();
+		kernel_wait_for_interrupt();
 	} while ((c = get_char_from_buffer()) != '\n');
 	vd_clear();
 }
@@ -5,6 +5,7 @@
 #include "idt_loader.h"
 #include "defs.h"
 #include "interrupts.h"
+#include "apic.h"
 
 #pragma pack(push) /* Push de la alineación actual */
 #pragma pack(1)    /* Alinear las siguiente estructuras a 1 byte */
@@ -37,9 +38,16 @@ void load_idt()
 	setup_IDT_entry(0x20, (uint64_t)&_irq00Handler);
 	setup_IDT_entry(0x21, (uint64_t)&_irq01Handler);
 
+	// Interrupciones del Local APIC: timer de los APs, IPIs entre CPUs y espurias
+	setup_IDT_entry(LAPIC_TIMER_VECTOR, (uint64_t)&_lapicTimerHandler);
+	setup_IDT_entry(RESCHED_VECTOR, (uint64_t)&_reschedHandler);
+	setup_IDT_entry(AP_START_VECTOR, (uint64_t)&_apStartHandler);
+	setup_IDT_entry(SPURIOUS_VECTOR, (uint64_t)&_spuriousHandler);
+
 	// excepciones
 	setup_IDT_entry(0x00, (uint64_t)&_exception0Handler);
 	setup_IDT_entry(0x06, (uint64_t)&_exception6Handler);
+	setup_IDT_entry(0x07, (uint64_t)&_exception7Handler); // #NM: estado SSE perezoso
 
 	// Solo interrupcion timer tick y teclado habilitadas
 	picMasterMask(0xFC);
@@ -4,29 +4,49 @@
 #include "time.h"
 #include <stdint.h>
 #include "keyboard.h"
+#include "apic.h"
+#include "scheduler.h"
+#include "smp.h"
 
-static uint64_t int_20(uint64_t rsp);
-static void     int_21();
+static void int_20();
+static void int_21();
 
-uint64_t irq_dispatcher(uint64_t irq, uint64_t rsp)
+void irq_dispatcher(uint64_t irq)
 {
 	switch (irq) {
 	case 0:
-		rsp = int_20(rsp);
+		int_20();
 		break;
 	case 1:
 		int_21();
 		break;
 	}
-	return rsp;
 }
 
-uint64_t int_20(uint64_t rsp)
+void int_20()
 {
-	return timer_handler(rsp);
+	timer_handler();
 }
 
 void int_21()
 {
 	handle_pressed_key();
-}
\ No newline at end of file
+}
+// Interrupciones que llegan por el Local APIC
+void lapic_irq_dispatcher(uint64_t vector)
+{
+	switch (vector) {
+	case LAPIC_TIMER_VECTOR:
+		// En el BSP el timer del LAPIC solo se usa como one-shot durante el tickless idle
+		if (this_cpu()->id == BSP_CPU) {
+			timer_deadline_handler();
+		} else {
+			schedule();
+		}
+		break;
+	case RESCHED_VECTOR:
+		tick_rearm();
+		scheduler_handle_ipi();
+		break;
+	}
+}
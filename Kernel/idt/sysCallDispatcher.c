@@ -75,6 +75,32 @@ void *syscalls[] = {
         &sys_open_named_pipe, // 45
         &sys_close_fd,        // 46
         &sys_pipes_info,      // 47
+
+        &sys_sched_stats, // 48
+        &sys_set_quantum, // 49
+
+        &sys_clock_ns,  // 50
+        &sys_nanosleep, // 51
+
+        &sys_sched_deadline, // 52
+
+        &sys_waitany, // 53
+
+        &sys_set_group,   // 54
+        &sys_group_quota, // 55
+        &sys_groups_info, // 56
+
+        &sys_set_batch, // 57
+
+        &sys_thread_create, // 58
+        &sys_thread_join,   // 59
+
+        &sys_slab_info, // 60
+
+        &sys_mutex_open, // 61
+
+        &sys_process_info,  // 62
+        &sys_process_count, // 63
 };
 
 static uint64_t sys_regs(char *buffer)
@@ -105,7 +131,7 @@ static int sys_write(uint64_t fd, const char *buffer, uint64_t count)
 	}
 
 	// es un pipe
-	if (!q_contains(p->open_fds, fd)) {
+	if (!proc_fd_is_open(p, fd)) {
 		return -1;
 	}
 
@@ -134,7 +160,7 @@ static int sys_read(int fd, char *buffer, uint64_t count)
 	}
 
 	// es un pipe
-	if (!q_contains(p->open_fds, fd)) {
+	if (!proc_fd_is_open(p, fd)) {
 		return -1;
 	}
 
@@ -273,17 +299,28 @@ static mem_info_t sys_mem_info(void)
 	return get_mem_status(get_kernel_memory_manager());
 }
 
+static int sys_slab_info(slab_info_t *buf, int max_count)
+{
+	return slab_get_info(buf, max_count);
+}
+
 // ===================== Processes syscalls =====================
 
-// Crea un proceso: reserva un PID libre y delega en el scheduler
-static int64_t
-sys_create_process(void *entry, int argc, const char **argv, const char *name, int fds[2])
+// Crea un proceso: reserva un PID libre y delega en el scheduler. stack_size 0 usa el tamaño por
+// defecto (PROCESS_STACK_SIZE)
+static int64_t sys_create_process(void        *entry,
+                                  int          argc,
+                                  const char **argv,
+                                  const char  *name,
+                                  int          fds[2],
+                                  uint64_t     stack_size)
 {
 	if (entry == NULL || name == NULL) {
 		return -1;
 	}
 
-	int new_pid = scheduler_add_process((process_entry_t)entry, argc, argv, name, fds);
+	int new_pid =
+	        scheduler_add_process((process_entry_t)entry, argc, argv, name, fds, stack_size);
 	return new_pid;
 }
 
@@ -339,11 +376,25 @@ static int sys_processes_info(process_info_t *buf, int max_count)
 	return scheduler_get_processes(buf, max_count);
 }
 
+static int sys_process_info(int pid, process_info_t *info)
+{
+	return scheduler_get_process_info(pid, info);
+}
+
+static int sys_process_count(void)
+{
+	return scheduler_get_process_count();
+}
+
 // SEMÁFOROS (API basada en nombre)
 static int64_t sys_sem_open(const char *name, int value)
 {
 	return (int64_t)sem_open((char *)name, value);
 }
+static int64_t sys_mutex_open(const char *name)
+{
+	return mutex_open((char *)name);
+}
 static void sys_sem_close(const char *name)
 {
 	sem_close((char *)name);
@@ -366,8 +417,8 @@ static int sys_create_pipe(int fds[2])
 
 	pid_t pid = scheduler_get_current_pid();
 	PCB  *p   = scheduler_get_process(pid);
-	q_add(p->open_fds, fds[0]);
-	q_add(p->open_fds, fds[1]);
+	proc_fd_add(p, fds[0]);
+	proc_fd_add(p, fds[1]);
 	return pipe_id;
 }
 
@@ -403,13 +454,9 @@ static int sys_open_named_pipe(char *name, int fds[2])
 	pid_t pid = scheduler_get_current_pid();
 	PCB  *p   = scheduler_get_process(pid);
 
-	// Agregar ambos FDs a la lista de open_fds del proceso
-	if (!q_contains(p->open_fds, fds[0])) {
-		q_add(p->open_fds, fds[0]);
-	}
-	if (!q_contains(p->open_fds, fds[1])) {
-		q_add(p->open_fds, fds[1]);
-	}
+	// Agregar ambos FDs a la tabla de fds abiertos del proceso
+	proc_fd_add(p, fds[0]);
+	proc_fd_add(p, fds[1]);
 
 	return pipe_id;
 }
@@ -418,7 +465,7 @@ static int sys_close_fd(int fd)
 {
 	pid_t pid = scheduler_get_current_pid();
 	PCB  *p   = scheduler_get_process(pid);
-	if (q_remove(p->open_fds, fd)) {
+	if (proc_fd_remove(p, fd)) {
 		return close_fd(fd);
 	}
 
@@ -429,3 +476,83 @@ static int sys_pipes_info(pipe_info_t *buf, int max_count)
 {
 	return pipes_info(buf, max_count);
 }
+
+static int sys_sched_stats(sched_stats_t *buf)
+{
+	return scheduler_get_stats(buf);
+}
+
+// Con ticks == 0 solo consulta el quantum actual de la prioridad
+static int sys_set_quantum(uint8_t priority, uint32_t ticks)
+{
+	if (ticks == 0) {
+		return scheduler_get_quantum(priority);
+	}
+	return scheduler_set_quantum(priority, ticks);
+}
+
+static uint64_t sys_clock_ns(void)
+{
+	return clock_ns();
+}
+
+static void sys_nanosleep(uint64_t nanoseconds)
+{
+	nanosleep(nanoseconds);
+}
+
+// runtime == 0 saca al proceso de la clase de tiempo real
+static int sys_sched_deadline(uint32_t runtime, uint32_t period, uint32_t deadline)
+{
+	return scheduler_set_deadline(runtime, period, deadline);
+}
+
+// Espera a cualquier hijo: devuelve su pid y deja su valor de retorno en status (si no es NULL)
+static int64_t sys_waitany(int64_t *status)
+{
+	int     ret_value;
+	int64_t pid = scheduler_waitany(&ret_value);
+	if (pid >= 0 && status != NULL) {
+		*status = ret_value;
+	}
+	return pid;
+}
+
+static int sys_set_group(int pid, int group)
+{
+	return scheduler_set_group(pid, group);
+}
+
+// quota == 0 saca el límite del grupo
+static int sys_group_quota(int group, uint32_t quota, uint32_t period)
+{
+	return scheduler_set_group_quota(group, quota, period);
+}
+
+static int sys_groups_info(group_info_t *buf, int max_count)
+{
+	return scheduler_get_groups(buf, max_count);
+}
+
+static int sys_set_batch(int pid, bool batch)
+{
+	return scheduler_set_batch(pid, batch);
+}
+
+// stack_size 0: PROCESS_STACK_SIZE
+static int64_t sys_thread_create(thread_entry_t entry, void *arg, uint64_t stack_size)
+{
+	return scheduler_add_thread(entry, arg, stack_size);
+}
+
+static int sys_thread_join(int tid, int64_t *status)
+{
+	int ret_value;
+	if (scheduler_join_thread(tid, &ret_value) != 0) {
+		return -1;
+	}
+	if (status != NULL) {
+		*status = ret_value;
+	}
+	return 0;
+}
@@ -0,0 +1,34 @@
+#ifndef APIC_H
+#define APIC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Vectores de las interrupciones del Local APIC (los del PIC están remapeados a 0x20-0x2F)
+#define LAPIC_TIMER_VECTOR 0x40
+#define RESCHED_VECTOR 0x41
+#define AP_START_VECTOR 0x42
+#define SPURIOUS_VECTOR 0xF8 // Pure64 configura el Spurious Interrupt Vector Register con 0xF8
+
+// Inicializa el acceso al Local APIC con la dirección que dejó Pure64 en el InfoMap.
+// Devuelve false si la máquina no tiene Local APIC.
+bool lapic_init(void);
+bool lapic_present(void);
+
+uint8_t lapic_id(void);
+void    lapic_eoi(void);
+
+// Envía una interrupción (fixed) a la CPU con el APIC ID indicado
+void lapic_send_ipi(uint8_t apic_id, uint8_t vector);
+
+// Mide cuántas cuentas del timer del Local APIC entran en 1/hz segundos usando el canal 2 del PIT
+// como referencia. Se llama una sola vez desde el BSP: todas las CPUs comparten la frecuencia.
+uint32_t lapic_timer_calibrate(uint32_t hz);
+
+// Arranca el timer del Local APIC de la CPU actual en modo periódico
+void lapic_timer_start(uint32_t initial_count, uint8_t vector);
+// Interrumpe una sola vez después de count cuentas
+void lapic_timer_oneshot(uint32_t count, uint8_t vector);
+void lapic_timer_stop(void);
+
+#endif
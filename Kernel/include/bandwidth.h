@@ -0,0 +1,62 @@
+#ifndef BANDWIDTH_H
+#define BANDWIDTH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "process.h"
+
+// Grupos de procesos con cuota de CPU (sched/bandwidth.c), sobre cualquiera de las dos políticas.
+// Cada proceso pertenece a un grupo y sus hijos heredan el suyo; ROOT_GROUP es el de todos y no
+// tiene límite. Un grupo con cuota puede usar hasta quota ticks de CPU (sumando todas las CPUs) en
+// cada período de period ticks: cuando los gasta, sus procesos READY no se eligen (quedan
+// estacionados fuera de las colas) hasta que empieza el próximo período. Los procesos de tiempo
+// real no se cobran a su grupo: tienen su propia reserva.
+
+#define MAX_GROUPS 16
+#define ROOT_GROUP 0
+#define MAX_BW_PERIOD 1000 // ticks (10 segundos con el PIT a 100 Hz)
+
+// Estructura para exponer el uso de cada grupo a userland
+typedef struct group_info {
+	int      id;
+	uint32_t quota;        // ticks por período (0: sin límite)
+	uint32_t period;       // ticks
+	uint32_t period_used;  // ticks usados en el período actual
+	uint64_t total_ticks;  // ticks de CPU usados desde el arranque
+	uint64_t throttles;    // veces que gastó la cuota antes de que termine el período
+	uint32_t processes;    // procesos del grupo
+	bool     throttled;    // sin cuota hasta el próximo período
+} group_info_t;
+
+void bw_init(void);
+
+// quota == 0 saca el límite; ROOT_GROUP no puede tenerlo. Devuelve -1 si los parámetros no son
+// válidos. Empieza un período nuevo: deja en released los procesos que estaban estacionados
+// (enlazados por bw_next) para volver a encolarlos.
+int bw_set_quota(int group, uint32_t quota, uint32_t period, uint64_t now, PCB **released);
+
+// Le cobra un tick de CPU al grupo del proceso
+void bw_charge(PCB *p);
+
+static inline bool bw_valid_group(int group)
+{
+	return group >= 0 && group < MAX_GROUPS;
+}
+
+// true si el grupo del proceso gastó su cuota del período
+bool bw_throttled(PCB *p);
+// Deja al proceso (READY, fuera de las colas) esperando el próximo período de su grupo
+void bw_park(PCB *p);
+// Lo saca de la espera si estaba estacionado (se bloquea, termina o cambia de grupo)
+void bw_detach(PCB *p);
+// Hay procesos estacionados: hace falta el tick para reponer las cuotas
+bool bw_pending(void);
+
+// Empieza los períodos que vencieron. Devuelve los procesos que dejan de estar estacionados
+// (enlazados por bw_next) para volver a encolarlos.
+PCB *bw_tick(uint64_t now);
+
+// Completa el uso de todos los grupos (processes lo completa el scheduler)
+void bw_get_info(group_info_t info[MAX_GROUPS]);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "process.h"
+
+// Clase de tiempo real EDF (sched/deadline.c), por encima de la política de las colas READY.
+// Un proceso declara (runtime, period, deadline) en ticks: en cada período puede correr hasta
+// runtime ticks y tiene que terminar su trabajo antes de deadline ticks desde que empezó el
+// período. Los procesos de esta clase corren antes que cualquier proceso normal y, entre ellos,
+// primero el de deadline absoluto más próximo. Marcan el fin del trabajo del período con
+// sys_yield; si el deadline vence antes, se les cuenta un deadline perdido.
+//
+// Cada proceso queda fijo en una CPU, que lo admite solo si la suma de runtime/deadline de sus
+// procesos de tiempo real no pasa de 1 (con deadline == period es la utilización).
+
+#define DL_UNIT 1024       // utilización 1.0 en punto fijo
+#define MAX_DL_PERIOD 1000 // ticks (10 segundos con el PIT a 100 Hz)
+
+void dl_init(void);
+
+// Admite al proceso en la clase, en la CPU con más lugar, o lo saca de la clase si runtime es 0.
+// Devuelve la CPU en la que quedó o NO_CPU si los parámetros no son válidos o no entra en ninguna
+int  dl_set_params(PCB *p, uint32_t runtime, uint32_t period, uint32_t deadline, uint64_t now);
+void dl_detach(PCB *p);
+
+static inline bool dl_is_member(PCB *p)
+{
+	return p->dl_period != 0;
+}
+
+// Arranca los períodos que vencieron y cuenta los deadlines perdidos de los procesos de la CPU
+void dl_tick(int cpu, uint64_t now);
+// Proceso de tiempo real listo con el deadline más próximo de la CPU (sin sacarlo), o NULL
+PCB *dl_pick(int cpu);
+// true si current (de cualquier clase) tiene que dejarle la CPU a un proceso de tiempo real, o
+// si es de tiempo real y ya no puede seguir corriendo en este período
+bool     dl_should_preempt(int cpu, PCB *current);
+uint32_t dl_set_running(PCB *p, uint64_t now); // devuelve los ticks que le quedan del período
+void     dl_update_current(PCB *p, uint64_t now);
+void     dl_job_done(PCB *p);
+uint32_t dl_count(int cpu);
+
+#endif
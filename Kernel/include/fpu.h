@@ -0,0 +1,33 @@
+#ifndef FPU_H
+#define FPU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "process.h"
+#include "smp.h"
+
+// Estado x87/SSE/AVX de los procesos, guardado y restaurado de forma perezosa. El kernel se
+// compila sin SSE, así que solo el código de usuario toca esos registros. Al cambiar de proceso
+// se prende CR0.TS: la primera instrucción vectorial del proceso entrante genera #NM y recién ahí
+// se cargan sus registros. Al sacarlo de la CPU solo se guardan si los usó en ese turno, así que
+// un proceso que nunca usa SSE no paga nada (ni siquiera el área de guardado).
+
+#define FPU_MAX_STATE_SIZE 1024 // x87 + SSE + AVX con XSAVE ocupa 832 bytes
+
+// Habilita SSE (y AVX/XSAVE si la CPU los tiene) en la CPU actual. La primera llamada, en el BSP,
+// detecta las extensiones y arma el estado inicial que reciben los procesos nuevos.
+void fpu_init_cpu(void);
+
+// Cambio de contexto en la CPU: guarda el estado de prev si lo usó en su turno y deja CR0.TS
+// prendido salvo que los registros ya tengan el estado de next
+void fpu_switch(cpu_t *cpu, PCB *prev, PCB *next);
+
+// Handler de #NM (desde interrupts.asm): carga el estado del proceso actual
+void fpu_handle_nm(void);
+
+// Libera el área de guardado del proceso (al liberar su PCB)
+void fpu_release(PCB *p);
+
+uint64_t fpu_trap_count(void);
+
+#endif
@@ -21,8 +21,15 @@ void _irq04Handler(void);
 void _irq05Handler(void);
 void _irq128Handler(void);
 
+// Interrupciones del Local APIC (SMP)
+void _lapicTimerHandler(void);
+void _reschedHandler(void);
+void _apStartHandler(void);
+void _spuriousHandler(void);
+
 void _exception0Handler(void);
 void _exception6Handler(void);
+void _exception7Handler(void);
 
 void _cli(void);
 
@@ -3,22 +3,33 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "queue.h"
 
-#define MAX_PROCESSES 64
+#define MAX_PROCESSES 4096 // espacio de PIDs; la tabla de procesos crece hasta este tamaño
+#define INITIAL_PROCESS_TABLE 64
+#define PID_BITMAP_WORDS (MAX_PROCESSES / 64)
 #define MAX_PROCESS_NAME_LENGTH 32
-#define PROCESS_STACK_SIZE (4096 * 2) // 8KB stack
+#define PROCESS_STACK_SIZE (4096 * 2) // 8KB stack (el que se usa si no se pide otro tamaño)
+#define MIN_STACK_SIZE 4096
+#define MAX_STACK_SIZE (4096 * 16) // 64KB
 #define MAX_PID (MAX_PROCESSES - 1)
+#define MAX_FDS 128 // alcanza para los fds de todos los pipes (FIRST_FREE_FD + 2 * MAX_PIPES)
+#define FD_BITMAP_WORDS (MAX_FDS / 64)
+#define ARGV_INLINE_SIZE 256 // bytes de argv (punteros y strings) que entran en el PCB
 #define KILLED_RET_VALUE -1
 
 #define INIT_PID 0
 #define SHELL_PID 1
 #define NO_PID -1
+#define ANY_CHILD -2 // waiting_on: espera a que termine cualquiera de sus hijos
+#define NO_CPU -1
+
+#define WAIT_HIST_BUCKETS 20 // histograma log2 de la espera en READY, en us (el último: >= 2^19)
 
 #define OK 0
 #define ERROR -1
 
 typedef int (*process_entry_t)(int argc, char **argv);
+typedef int (*thread_entry_t)(void *arg);
 
 // Estados de proceso
 typedef enum { PS_READY = 0, PS_RUNNING, PS_BLOCKED, PS_TERMINATED } process_status_t;
@@ -30,33 +41,114 @@ typedef struct PCB {
 	int  parent_pid; // PID del proceso padre (-1 si no tiene)
 	char name[MAX_PROCESS_NAME_LENGTH];
 
+	// Árbol de procesos: listas intrusivas de hijos, enlazadas por sibling_next/sibling_prev
+	struct PCB *children;     // hijos que siguen corriendo
+	struct PCB *zombies;      // hijos terminados que esperan un wait
+	struct PCB *sibling_next; // siguiente en la lista de su padre
+	struct PCB *sibling_prev;
+
+	// Hilos (sys_thread_create): comparten la tabla de fds, el grupo y la contabilidad de su
+	// proceso. No son hijos: los de un proceso se enlazan por sibling_next/sibling_prev
+	struct PCB *owner;      // proceso al que pertenece el hilo (él mismo si no es un hilo)
+	struct PCB *threads;    // hilos del proceso, corriendo o terminados sin join
+	void       *thread_arg; // argumento de la función de entrada del hilo
+	int         joiner;     // PID del hilo que espera su join (NO_PID si ninguno)
+
 	// Estado y scheduling
 	process_status_t status;
 	uint8_t          priority;           // Prioridad base (0-2, 0 = mayor prioridad)
-	uint8_t          effective_priority; // Prioridad efectiva (puede ser promovida por aging)
+	uint8_t          effective_priority; // Nivel actual en la MLFQ (entre priority y MIN_PRIORITY)
+	uint8_t          pi_priority;        // Heredada de quien espera un mutex suyo (o MIN_PRIORITY)
 	uint64_t         last_tick;
+	uint32_t         ticks_left; // Ticks que le quedan del quantum actual
+	bool             io_wait;    // Bloqueado esperando una lectura de teclado o de pipe
+	bool             batch;      // Clase batch: corre solo si no hay procesos normales listos
 
 	// Contexto de ejecución
-	void *stack_base;    // Base del stack
-	void *stack_pointer; // RSP actual (apunta al contexto guardado)
+	void    *stack_base;    // Base del stack
+	uint64_t stack_size;    // potencia de 2 entre MIN_STACK_SIZE y MAX_STACK_SIZE
+	void    *stack_pointer; // RSP actual (apunta al contexto guardado)
 
-	// Función de entrada
+	// Función de entrada. argv es un solo bloque con los punteros seguidos de los strings; si entra
+	// en argv_inline no se aloca aparte
 	process_entry_t entry;
 	int             argc;
 	char          **argv;
+	uint64_t        argv_inline[ARGV_INLINE_SIZE / sizeof(uint64_t)];
 
 	// Estadísticas
 	uint64_t cpu_ticks;    // Total de ticks de CPU usados
 	int      return_value; // Valor de retorno (para exit)
-	int      waiting_on;   // PID que está esperando (-1 si ninguno)
+	int      waiting_on;   // PID que está esperando (-1 si ninguno, ANY_CHILD en waitany)
+	uint64_t voluntary_switches;   // Veces que cedió la CPU antes de agotar su quantum
+	uint64_t involuntary_switches; // Veces que fue desalojado (quantum agotado o preemption)
+	uint64_t wakeups;              // Veces que pasó de BLOCKED a READY
+
+	// Latencia de la cola READY: cuánto espera desde que queda listo hasta que corre
+	uint64_t ready_since;   // clock_ns() de cuando pasó a READY (0 si no está esperando)
+	uint64_t wait_total_ns; // suma de todas las esperas
+	uint64_t wait_max_ns;   // peor espera
+	uint32_t wait_hist[WAIT_HIST_BUCKETS]; // bucket i: esperas de [2^i, 2^(i+1)) us
 
 	// file descriptors
 	int  read_fd;
 	int  write_fd;
 	bool killable; // si false, el proceso no puede ser matado (init/shell)
 
-	// queues
-	queue_t open_fds; // lista de fds abiertos
+	// fds de pipes abiertos por el proceso (bit i encendido <=> tiene abierto el fd i)
+	uint64_t open_fds[FD_BITMAP_WORDS];
+
+	// Enlaces intrusivos de la cola READY (encolar/desencolar sin alocar memoria)
+	struct PCB *rq_next;
+	struct PCB *rq_prev;
+	uint8_t     rq_level; // cola en la que está encolado (válido solo si on_rq)
+	bool        on_rq;    // true si está encolado en alguna cola READY
+
+	// Estado de la política CFS (sched/cfs.c)
+	uint64_t vruntime;   // runtime virtual en ns, ponderado por el peso de su prioridad
+	uint64_t exec_start; // clock_ns() de la última vez que se contabilizó su runtime
+	uint32_t rq_index;   // posición en el heap de su CPU (válido solo si on_rq)
+
+	// Clase de tiempo real EDF (sched/deadline.c). dl_period == 0: el proceso no es de la clase
+	struct PCB *dl_next;         // siguiente proceso de tiempo real de su CPU
+	uint32_t    dl_runtime;      // ticks de CPU por período
+	uint32_t    dl_period;       // ticks
+	uint32_t    dl_deadline;     // ticks desde el inicio de cada período
+	uint32_t    dl_bandwidth;    // runtime/deadline en DL_UNIT, reservado en su CPU
+	uint32_t    dl_budget;       // ticks que le quedan en el período actual
+	uint64_t    dl_abs_deadline; // tick en el que vence el trabajo del período actual
+	uint64_t    dl_next_release; // tick en el que empieza el próximo período
+	uint64_t    dl_last_update;  // tick en el que se le descontó budget por última vez
+	uint32_t    dl_missed;       // períodos en los que venció el deadline sin terminar
+	bool        dl_done;         // terminó (sys_yield) el trabajo del período actual
+	bool        dl_miss_counted; // ya se contó el deadline perdido del período actual
+
+	// Grupo con cuota de CPU (sched/bandwidth.c)
+	uint8_t     group;     // lo hereda de su padre
+	struct PCB *bw_next;   // lista de estacionados de su grupo (válido solo si bw_parked)
+	struct PCB *bw_prev;
+	bool        bw_parked; // READY pero fuera de las colas: su grupo gastó la cuota
+
+	// Cola de espera intrusiva del semáforo en el que está bloqueado (synchro.c)
+	struct PCB *sem_next;
+	void       *sem_waiting; // semáforo que espera (NULL si ninguno)
+
+	// Enlaces intrusivos de la rueda de timers (procesos durmiendo en sleep)
+	struct PCB *timer_next;
+	struct PCB *timer_prev;
+	uint64_t    wake_tick; // tick en el que hay que despertarlo (válido solo si on_timer)
+	bool        on_timer;  // true si está en la rueda de timers
+
+	// Estado x87/SSE/AVX (fpu.c): se aloca recién cuando el proceso usa esos registros
+	void  *fpu_state; // área de FXSAVE/XSAVE alineada (NULL si nunca los usó)
+	void  *fpu_alloc; // puntero devuelto por el memory manager, para liberarla
+	int8_t fpu_cpu;   // CPU en la que se guardó su estado por última vez
+
+	// SMP
+	int8_t   cpu;        // CPU dueña de la cola READY del proceso (la última en la que corrió)
+	int8_t   running_on; // CPU que lo está corriendo en este momento (NO_CPU si ninguna)
+	uint32_t lock_depth; // profundidad del lock del kernel guardada al sacarlo de la CPU
+	bool     reap;       // liberar sus recursos cuando la CPU que lo corre lo suelte
 } PCB;
 
 // Estructura para exponer información de procesos a userland
@@ -70,16 +162,49 @@ typedef struct process_info {
 	int              write_fd;
 	uint64_t         stack_base;
 	uint64_t         stack_pointer;
+	uint64_t         voluntary_switches;
+	uint64_t         involuntary_switches;
+	uint64_t         cpu_ticks;
+	uint64_t         wakeups;
+	uint64_t         wait_total_ns;
+	uint64_t         wait_max_ns;
+	uint32_t         wait_hist[WAIT_HIST_BUCKETS];
+	int              cpu;
+	bool             deadline;         // proceso de la clase de tiempo real
+	bool             batch;            // proceso de la clase batch
+	int              owner_pid;        // proceso del hilo (su propio PID si no es un hilo)
+	uint32_t         missed_deadlines; // deadlines perdidos (clase de tiempo real)
+	int              group;
 } process_info_t;
 
-// Creación y limpieza (usadas por scheduler)
+// Creación y limpieza (usadas por scheduler). stack_size se redondea a una potencia de 2 (0: el
+// tamaño por defecto); si pasa de MAX_STACK_SIZE no se crea el proceso
 PCB *proc_create(int             pid,
                  process_entry_t entry,
                  int             argc,
                  const char    **argv,
                  const char     *name,
                  bool            killable,
-                 int             fds[2]);
+                 int             fds[2],
+                 uint64_t        stack_size);
+// Hilo del proceso owner: no copia argv ni abre fds (usa los de owner)
+PCB *proc_create_thread(int            pid,
+                        PCB           *owner,
+                        thread_entry_t entry,
+                        void          *arg,
+                        uint64_t       stack_size);
 void free_process_resources(PCB *p);
 
+static inline bool proc_is_thread(PCB *p)
+{
+	return p->owner != p;
+}
+
+// Tabla de fds abiertos del proceso (la de un hilo es la de su proceso)
+bool proc_fd_is_open(PCB *p, int fd);
+void proc_fd_add(PCB *p, int fd);
+bool proc_fd_remove(PCB *p, int fd);
+// Saca de la tabla algún fd abierto y lo devuelve, o -1 si no tiene ninguno
+int proc_fd_poll(PCB *p);
+
 #endif 
\ No newline at end of file
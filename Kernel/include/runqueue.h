@@ -0,0 +1,64 @@
+#ifndef RUNQUEUE_H
+#define RUNQUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "process.h"
+#include "scheduler.h"
+
+// Política de las colas READY de cada CPU. Se elige al compilar, igual que el memory manager:
+//   - sched/priority_queues.c (por defecto): multi-level feedback queue de tres niveles
+//   - sched/cfs.c (SCHED=USE_CFS): fair-share por runtime virtual ponderado
+// scheduler.c maneja el ciclo de vida de los procesos, el cambio de contexto y el balanceo entre
+// CPUs; todo lo que decide qué proceso corre y por cuánto tiempo vive acá.
+//
+// Las dos políticas tienen además la clase batch (p->batch): sus procesos corren solo cuando no
+// hay ningún proceso normal listo en la CPU, de a turnos largos (BATCH_QUANTUM) y sin aging. El
+// que tiene un mutex que espera otro proceso (prioridad heredada) corre como normal hasta
+// soltarlo, para que la espera no dependa de que la CPU quede libre.
+
+static inline bool rq_is_batch(PCB *p)
+{
+	return p->batch && p->pi_priority == MIN_PRIORITY;
+}
+
+void rq_init(void);
+// Deja lugar en las colas de cada CPU para capacity procesos. scheduler.c la llama al crear la
+// tabla de procesos y cada vez que la agranda (nunca hay más encolados que lugares en la tabla).
+// 0, o -1 si no hay memoria (las colas quedan como estaban).
+int rq_reserve(uint32_t capacity);
+
+// Encola el proceso en la CPU p->cpu. No hace nada si ya está encolado.
+void rq_enqueue(PCB *p);
+// Lo saca de la cola en la que esté. No hace nada si no está encolado.
+void rq_remove(PCB *p);
+// Saca de la cola de la CPU el próximo proceso a correr, o NULL si está vacía
+PCB     *rq_pick(int cpu);
+uint32_t rq_count(int cpu);
+// Pasa un proceso que no está encolado a la CPU indicada
+void rq_migrate(PCB *p, int cpu);
+
+// true si en la cola de la CPU hay un proceso que debería desalojar a current (que no es init)
+bool rq_should_preempt(int cpu, PCB *current);
+// Contabiliza el tiempo de CPU que usó el proceso que está corriendo
+void rq_update_current(PCB *current);
+// Se llama al elegir a p para correr en la CPU: devuelve cuántos ticks puede correr sin ser
+// desalojado
+uint32_t rq_set_running(int cpu, PCB *p);
+// El proceso que corría deja la CPU (todavía no se lo volvió a encolar). slice_expired: la dejó
+// por haber gastado su turno completo
+void rq_put_prev(PCB *p, bool slice_expired);
+// El proceso pasa de BLOCKED a READY (antes de encolarlo). io: estaba esperando una lectura de
+// teclado o de pipe
+void rq_wakeup(PCB *p, bool io);
+// El proceso (que no está encolado) hereda la prioridad indicada por tener un mutex que espera
+// otro más prioritario: no corre por debajo de ella hasta que la herencia vuelva a MIN_PRIORITY
+void rq_set_inherited(PCB *p, uint8_t priority);
+// Mantenimiento periódico de la CPU (cada AGING_CHECK_INTERVAL ticks suyos; now es cpu->ticks)
+void rq_aging(int cpu, uint64_t now);
+
+// Quantum por prioridad (sys_set_quantum). -1 si la política no usa un quantum fijo.
+int rq_set_quantum(uint8_t priority, uint32_t ticks);
+int rq_get_quantum(uint8_t priority);
+
+#endif
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "process.h"
+#include "bandwidth.h"
 
 typedef int pid_t;
 
@@ -14,37 +15,106 @@ typedef int pid_t;
 
 // Aging constants
 #define AGING_CHECK_INTERVAL 10 // Cada cuántos ticks aplicar aging
-#define AGING_THRESHOLD 50      // Ticks sin correr para ser promovido
+#define MLFQ_BOOST_INTERVAL 100 // Ticks de CPU entre reseteos de todos a su prioridad base
+
+// Balanceo entre CPUs
+#define BALANCE_INTERVAL 20 // Cada cuántos ticks de una CPU intenta traerse trabajo de otra
+
+// Largo del quantum (en ticks) por nivel de prioridad: los procesos de mayor prioridad suelen ser
+// interactivos y ceden la CPU antes, los de menor prioridad corren más tiempo sin ser desalojados
+#define MAX_PRIORITY_QUANTUM 2
+#define DEFAULT_PRIORITY_QUANTUM 4
+#define MIN_PRIORITY_QUANTUM 8
+#define MAX_QUANTUM 100 // Tope para sys_set_quantum (1 segundo con el PIT a 100 Hz)
+// Turno de la clase batch: corre cuando la CPU no tiene otra cosa que hacer, así que conviene
+// cambiar de contexto lo menos posible
+#define BATCH_QUANTUM 20
+
+// Estadísticas del costo de scheduling (para verificar que el costo por tick no crece con la
+// cantidad de procesos listos)
+typedef struct sched_stats {
+	uint64_t ticks;        // Cantidad de decisiones de scheduling tomadas
+	uint64_t total_cycles; // Ciclos de TSC acumulados dentro de schedule()
+	uint64_t last_cycles;  // Ciclos de la última decisión
+	uint64_t max_cycles;   // Peor caso observado
+	uint64_t ready_count;  // Procesos encolados en las colas READY en este momento
+	uint64_t cpu_count;    // CPUs corriendo procesos
+	uint64_t migrations;   // Procesos que una CPU le robó a otra
+	uint64_t idle_wakeups; // Veces que se llamó al scheduler en una CPU sin trabajo
+	uint64_t fpu_traps;    // #NM: veces que un proceso recuperó sus registros SSE/AVX
+} sched_stats_t;
 
 // Inicialización
 int  init_scheduler(void);
 void scheduler_destroy(void);
 
-// Función principal del scheduler (llamada por timer interrupt)
-void *schedule(void *prev_rsp);
+// Función principal del scheduler (llamada en cada tick del timer). Si cambia de proceso, vuelve
+// recién cuando el proceso interrumpido vuelve a correr.
+void schedule(void);
+
+// Llamadas desde los handlers de interrupciones en SMP
+void scheduler_handle_ipi(void);    // IPI de replanificación de otra CPU
+void scheduler_syscall_entry(void); // Entrada a una syscall
 
-// Gestión de procesos
-int scheduler_add_process(
-        process_entry_t entry, int argc, const char **argv, const char *name, int fds[2]);
+// Gestión de procesos (stack_size 0: PROCESS_STACK_SIZE)
+int  scheduler_add_process(process_entry_t entry,
+                           int             argc,
+                           const char    **argv,
+                           const char     *name,
+                           int             fds[2],
+                           uint64_t        stack_size);
 int  scheduler_remove_process(pid_t pid);
+// Hilos (process.h): comparten la tabla de fds, el grupo y la contabilidad del proceso. Si el
+// proceso termina, sus hilos terminan con él.
+int  scheduler_add_thread(thread_entry_t entry, void *arg, uint64_t stack_size);
+int  scheduler_join_thread(pid_t tid, int *status);
 int  scheduler_set_priority(pid_t pid, uint8_t priority);
 int  scheduler_get_priority(pid_t pid);
+// Clase batch (runqueue.h): los hijos que cree después la heredan
+int  scheduler_set_batch(pid_t pid, bool batch);
+// Grupos con cuota de CPU (bandwidth.h)
+int  scheduler_set_group(pid_t pid, int group);
+int  scheduler_set_group_quota(int group, uint32_t quota, uint32_t period);
+int  scheduler_get_groups(group_info_t *buffer, int max_count);
+// Herencia de prioridad (synchro.c): el proceso no baja de `priority` mientras tenga un mutex
+// que espera alguien más prioritario. MIN_PRIORITY: no heredó nada.
+int  scheduler_set_inherited_priority(pid_t pid, uint8_t priority);
 void scheduler_yield(void);
 int  scheduler_kill_process(pid_t pid);
 PCB *scheduler_get_process(pid_t pid);
 void scheduler_exit_process(int64_t retValue);
 int  scheduler_waitpid(pid_t child_pid);
+int  scheduler_waitany(int *status);
 
 // Bloqueo/desbloqueo (para usar desde processes.c)
 int scheduler_block_process(pid_t pid);
 int scheduler_unblock_process(pid_t pid);
+// Marca que el proceso actual espera una lectura de teclado o de pipe (al despertarlo se lo
+// promueve como interactivo)
+void scheduler_set_io_wait(bool waiting);
 
 // Control de scheduling
+// Cede la CPU cambiando de contexto directamente, sin simular una interrupción: no cuenta un tick
+// ni se lo cobra al proceso. Vuelve cuando el proceso vuelve a ser elegido.
 void scheduler_force_reschedule(void);
 int  scheduler_get_current_pid(void);
 
 // Información de procesos
 int scheduler_get_processes(process_info_t *buffer, int max_count);
+// Información de un solo proceso: 0, o -1 si no existe
+int scheduler_get_process_info(pid_t pid, process_info_t *info);
+// Procesos e hilos en la tabla, para dimensionar el buffer de scheduler_get_processes
+int scheduler_get_process_count(void);
+
+// Estadísticas del scheduler
+int scheduler_get_stats(sched_stats_t *buffer);
+
+// Clase de tiempo real EDF para el proceso actual (runtime, period y deadline en ticks)
+int scheduler_set_deadline(uint32_t runtime, uint32_t period, uint32_t deadline);
+
+// Largo del quantum por prioridad
+int scheduler_set_quantum(uint8_t priority, uint32_t ticks);
+int scheduler_get_quantum(uint8_t priority);
 
 // Foreground process control (getter/setter)
 pid_t scheduler_get_foreground_pid(void);
@@ -0,0 +1,65 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "synchro.h"
+
+// Caches de objetos de tamaño fijo del kernel (memory/slab.c), sobre cualquiera de los dos memory
+// managers. Cada cache pide al memory manager slabs de SLAB_PAGE_SIZE (o más, si no entran
+// SLAB_MIN_OBJECTS objetos) y los parte en objetos; los libres quedan en una lista, así que alocar
+// y liberar es sacar y poner un puntero. Los slabs no se devuelven al memory manager.
+//
+// Si el cache tiene constructor, se llama una sola vez por objeto, cuando se parte el slab: quien
+// libera un objeto tiene que devolverlo en ese estado (así no hay que inicializarlo de nuevo en
+// cada alocación).
+
+#define SLAB_PAGE_SIZE 4096
+#define SLAB_MIN_OBJECTS 4
+#define SLAB_NAME_LENGTH 16
+
+typedef void (*slab_ctor_t)(void *object);
+
+// Cache de un tipo de objeto. Se declara estático en el módulo dueño con SLAB_CACHE; el resto de
+// los campos los maneja slab.c (el cache se registra para las estadísticas con su primer slab).
+typedef struct slab_cache {
+	const char        *name;
+	size_t             object_size;
+	slab_ctor_t        ctor;
+	size_t             stride;     // objeto más la palabra de control, alineado
+	size_t             slab_size;  // bytes de cada slab
+	uint32_t           per_slab;   // objetos por slab
+	void              *free_list;  // objetos libres, enlazados por su palabra de control
+	void              *slabs;      // slabs del cache, enlazados por su primera palabra
+	uint32_t           objects;    // objetos alocados
+	uint32_t           capacity;   // objetos en todos los slabs
+	uint32_t           slab_count;
+	struct slab_cache *next; // caches registrados
+	lock_t             lock; // serializa alloc/free entre CPUs (1 = libre)
+} slab_cache_t;
+
+#define SLAB_CACHE(cache_name, type, constructor)                                                  \
+	{                                                                                          \
+		.name = (cache_name), .object_size = sizeof(type), .ctor = (constructor),          \
+		.lock = 1                                                                          \
+	}
+
+// Estadísticas de un cache para userland
+typedef struct slab_info {
+	char     name[SLAB_NAME_LENGTH];
+	uint32_t object_size;
+	uint32_t objects;   // alocados
+	uint32_t capacity;  // objetos en todos sus slabs (alocados y libres)
+	uint32_t slabs;     // slabs pedidos al memory manager
+	uint32_t slab_size; // bytes de cada slab
+} slab_info_t;
+
+// NULL si no hay memoria para un slab nuevo
+void *slab_alloc(slab_cache_t *cache);
+// Ignora objetos que no son del cache o que ya estaban libres
+void slab_free(slab_cache_t *cache, void *object);
+// Completa hasta max_count caches registrados y devuelve cuántos completó
+int slab_get_info(slab_info_t *buffer, int max_count);
+
+#endif
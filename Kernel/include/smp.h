@@ -0,0 +1,75 @@
+#ifndef SMP_H
+#define SMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "process.h"
+
+#define MAX_CPUS 16
+#define BSP_CPU 0
+#define AP_STACK_SIZE (4096 * 4) // 16KB de stack de kernel para el contexto idle de cada AP
+
+// Datos propios de cada CPU. GS base apunta a la estructura de la CPU que está corriendo, así
+// this_cpu() es una sola lectura de memoria.
+typedef struct cpu {
+	struct cpu   *self; // tiene que ser el primer campo: get_cpu_local() lee [gs:0]
+	int           id;   // índice en el arreglo de CPUs (0 = BSP)
+	uint8_t       apic_id;
+	volatile bool online;
+	void         *stack_base; // stack del contexto idle (solo APs)
+
+	// Scheduling
+	PCB     *current;  // proceso corriendo en esta CPU (NULL si está en idle)
+	bool     in_idle;  // true mientras corre el contexto idle del AP
+	void    *idle_rsp; // contexto idle guardado mientras corre un proceso
+	uint32_t idle_lock_depth;
+	uint32_t lock_depth; // cuántas veces anidadas tiene tomado el lock del kernel
+	uint64_t ticks;      // decisiones de scheduling tomadas en esta CPU
+	uint64_t idle_ticks; // ticks en los que no tuvo nada para correr
+
+	// Tickless idle
+	bool     tick_stopped; // el timer periódico está apagado porque la CPU no tiene trabajo
+	uint64_t idle_wakeups; // veces que una interrupción llamó al scheduler estando en idle
+
+	// Estado x87/SSE/AVX perezoso (fpu.c)
+	struct PCB *fpu_owner; // proceso cuyo estado quedó cargado en los registros de esta CPU
+	bool        fpu_live;  // CR0.TS apagado: el proceso actual puede estar usando los registros
+} cpu_t;
+
+extern cpu_t *get_cpu_local(void);
+
+static inline cpu_t *this_cpu(void)
+{
+	return get_cpu_local();
+}
+
+// Configura los datos del BSP. Se llama antes de habilitar interrupciones.
+void smp_init(void);
+// Calibra el timer del Local APIC y hace entrar a los APs que Pure64 dejó en halt al kernel.
+// Necesita el memory manager inicializado (stacks de los APs).
+void   smp_start_aps(void);
+int    smp_cpu_count(void);
+cpu_t *smp_get_cpu(int id);
+
+// Cuenta inicial del timer del Local APIC para que interrumpa a la frecuencia del scheduler
+uint32_t smp_timer_count(void);
+
+// Pide a otra CPU que vuelva a llamar al scheduler (proceso despertado, bloqueado o matado)
+void smp_send_resched(int cpu_id);
+
+// Lock grande del kernel: se toma al entrar a cualquier interrupción o syscall y se suelta al
+// volver. Es recursivo por CPU; la profundidad viaja con cada proceso en los cambios de contexto.
+void kernel_lock(void);
+void kernel_unlock(void);
+// Espera una interrupción (sti + hlt) soltando el lock del kernel mientras tanto, para no
+// bloquear a las demás CPUs. Vuelve con interrupciones deshabilitadas.
+void kernel_wait_for_interrupt(void);
+// Suelta el lock del kernel por completo (devuelve la profundidad) y lo vuelve a tomar
+uint32_t kernel_unlock_all(void);
+void     kernel_relock(uint32_t depth);
+
+// Entrada de los APs (llamadas desde interrupts.asm)
+void *smp_ap_stack_top(void);
+void  smp_ap_main(void);
+
+#endif
@@ -13,6 +13,9 @@ typedef int lock_t;
 
 extern void acquire_lock(lock_t *lock);
 extern void release_lock(lock_t *lock);
+// Igual que acquire_lock pero con interrupciones deshabilitadas; devuelve los RFLAGS a restaurar
+extern uint64_t acquire_lock_irqsave(lock_t *lock);
+extern void     release_lock_irqrestore(lock_t *lock, uint64_t flags);
 extern void _cli(void);
 extern void _sti(void);
 
@@ -23,6 +26,9 @@ void init_semaphore_manager(void);
 // Inicializa el array de semáforos en NULL
 // Se llama UNA vez al inicio del kernel
 int64_t sem_open(char *name, int initial_value);
+// Como sem_open, pero crea un mutex: arranca en 1 y quien lo toma hereda la prioridad del más
+// prioritario de los que lo esperan. Se cierra y se usa con sem_close, sem_wait y sem_post.
+int64_t mutex_open(char *name);
 // Cierra un semáforo con un nombre dado.
 //  Si hay más procesos usándolo → solo decrementa contador
 //  Si es el último proceso → destruye el semáforo y libera memoria
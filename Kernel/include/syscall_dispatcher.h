@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "memory_manager.h"
+#include "slab.h"
 #include "process.h"
 #include "pipes.h"
 
@@ -36,10 +37,15 @@ static uint64_t sys_ticks();
 static void      *sys_malloc(size_t size);
 static void       sys_free(void *ptr);
 static mem_info_t sys_mem_info(void);
+static int        sys_slab_info(slab_info_t *buf, int max_count);
 
 // syscalls de procesos
-static int64_t
-sys_create_process(void *entry, int argc, const char **argv, const char *name, int fds[2]);
+static int64_t sys_create_process(void        *entry,
+                                  int          argc,
+                                  const char **argv,
+                                  const char  *name,
+                                  int          fds[2],
+                                  uint64_t     stack_size);
 static void    sys_exit(int status);
 static int64_t sys_getpid(void);
 static int64_t sys_kill(int pid);
@@ -49,6 +55,8 @@ static int64_t sys_wait(int pid);
 static int64_t sys_nice(int pid, int new_prio);
 static void    sys_yield();
 static int     sys_processes_info(process_info_t *buf, int max_count);
+static int     sys_process_info(int pid, process_info_t *info);
+static int     sys_process_count(void);
 
 // syscalls para foreground processes
 static int sys_set_foreground_process(int pid);
@@ -57,6 +65,7 @@ static int sys_get_foreground_process(void);
 
 // syscalls de semaforos
 static int64_t sys_sem_open(const char *name, int value);
+static int64_t sys_mutex_open(const char *name);
 static void    sys_sem_close(const char *name);
 static void    sys_sem_wait(const char *name);
 static void    sys_sem_post(const char *name);
@@ -68,4 +77,30 @@ static int  sys_open_named_pipe(char *name, int fds[2]);
 static int  sys_close_fd(int fd);
 static int  sys_pipes_info(pipe_info_t *buf, int max_count);
 
+// syscalls de estadísticas del scheduler
+static int sys_sched_stats(sched_stats_t *buf);
+static int sys_set_quantum(uint8_t priority, uint32_t ticks);
+
+// syscalls de reloj de alta resolución
+static uint64_t sys_clock_ns(void);
+static void     sys_nanosleep(uint64_t nanoseconds);
+
+// syscalls de la clase de tiempo real
+static int sys_sched_deadline(uint32_t runtime, uint32_t period, uint32_t deadline);
+
+// syscalls de procesos (continuación)
+static int64_t sys_waitany(int64_t *status);
+
+// syscalls de grupos con cuota de CPU
+static int sys_set_group(int pid, int group);
+static int sys_group_quota(int group, uint32_t quota, uint32_t period);
+static int sys_groups_info(group_info_t *buf, int max_count);
+
+// syscalls de la clase batch
+static int sys_set_batch(int pid, bool batch);
+
+// syscalls de hilos
+static int64_t sys_thread_create(thread_entry_t entry, void *arg, uint64_t stack_size);
+static int     sys_thread_join(int tid, int64_t *status);
+
 #endif
\ No newline at end of file
@@ -3,13 +3,28 @@
 
 #include <stdint.h>
 
-uint64_t timer_handler(uint64_t rsp);
+struct PCB;
+
+void     timer_handler();
+// One-shot del LAPIC del BSP: vence un proceso dormido mientras el PIT está enmascarado
+void     timer_deadline_handler();
 uint64_t ticks_elapsed();
 int      seconds_elapsed();
 void     sleep(int seconds);
+void     sleep_cancel(struct PCB *p); // saca de la rueda de timers a un proceso matado
+uint64_t clock_ns();                  // reloj monotónico en ns desde el arranque (TSC)
+void     nanosleep(uint64_t nanoseconds);
 void     get_date(uint8_t *buffer);
 void     get_time(uint8_t *buffer);
 
+// Tickless idle: una CPU sin trabajo apaga su timer periódico y lo vuelve a prender cuando le
+// llega un proceso. ticks_elapsed() sigue siendo correcto con el tick del BSP apagado.
+void timer_calibrate_tsc();
+void tick_stop();
+void tick_restart();
+// Otra CPU agregó un proceso dormido: el BSP reprograma su one-shot si tiene el tick apagado
+void tick_rearm();
+
 // Import from interrupts.h
 extern void _hlt(void);
 
@@ -15,8 +15,8 @@
 #include "scheduler.h"
 #include "synchro.h"
 #include "pipes.h"
-
-extern void timer_tick();
+#include "smp.h"
+#include "fpu.h"
 
 extern uint8_t text;
 extern uint8_t rodata;
@@ -52,6 +52,10 @@ void *initializeKernelBinary()
 
 	clearBSS(&bss, &endOfKernel - &bss);
 
+	// Los handlers de interrupción usan los datos por CPU: tienen que estar antes del sti
+	smp_init();
+	fpu_init_cpu();
+
 	load_idt();
 
 	return getStackBase();
@@ -61,6 +65,11 @@ int main()
 {
 	init_kernel_memory_manager();
 
+	// Antes de inicializar el scheduler: mientras no esté listo, los ticks de los APs y del PIT
+	// no cambian de contexto (las calibraciones tardan ~60 ms)
+	timer_calibrate_tsc();
+	smp_start_aps();
+
 	init_scheduler();
 
 	init_semaphore_manager();
@@ -69,7 +78,8 @@ int main()
 
 	init_keyboard_sem();
 
-	timer_tick();
+	// Primer cambio de contexto: el contexto de arranque no se retoma
+	scheduler_force_reschedule();
 
 	return -1;
 }
@@ -5,26 +5,36 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "naiveConsole.h"
+#include "synchro.h"
 
 #define MIN_ORDER 5                            // 2^5 = 32 bytes (tamaño mínimo)
 #define MAX_ORDER 25                           // 2^25 = 32 MB (tamaño máximo de bloque)
 #define NUM_ORDERS (MAX_ORDER - MIN_ORDER + 1) // 21 niveles
+#define BASE_ALIGN 4096 // los bloques de 4 KB o más quedan alineados a página
 
-// Nodo de la lista libre para cada orden
+// El orden y el estado de cada bloque no van en el bloque sino en block_info, un byte por cada
+// bloque mínimo del heap: en el del comienzo de un bloque, su orden (más BLOCK_FREE si está libre);
+// en el resto, 0. Así un pedido de 2^k bytes usa un bloque de 2^k (no del doble por un header), y
+// liberar un puntero que no es el comienzo de un bloque alocado se ignora.
+#define BLOCK_FREE 0x80
+#define NOT_A_BLOCK 0
+
+// Nodo de la lista libre para cada orden: vive en el espacio del bloque libre
 typedef struct buddy_node_t {
-	struct buddy_node_t *next;  // Siguiente en la lista libre
-	struct buddy_node_t *prev;  // Anterior en la lista libre
-	bool                 free;  // ¿Está libre?
-	uint8_t              order; // Orden del bloque (2^order bytes)
+	struct buddy_node_t *next; // Siguiente en la lista libre
+	struct buddy_node_t *prev; // Anterior en la lista libre
 } buddy_node_t;
 
 // Estructura del Buddy Memory Manager
 struct memory_manager_CDT {
 	void         *base_address;           // Dirección base de la memoria
 	size_t        total_size;             // Tamaño total
+	uint8_t      *block_info;             // Orden y estado de cada bloque (ver BLOCK_FREE)
 	buddy_node_t *free_lists[NUM_ORDERS]; // Array de listas libres por orden
+	uint32_t      free_orders;            // Bit i: la lista de MIN_ORDER + i no está vacía
 	size_t        allocated_blocks;       // Bloques allocados
 	size_t        total_allocated;        // Bytes totales allocados
+	lock_t        lock;                   // Serializa alloc/free entre CPUs (1 = libre)
 };
 
 static memory_manager_ADT kernel_mm = NULL;
@@ -37,21 +47,18 @@ static size_t order_to_size(uint8_t order)
 	return (1ULL << order); // 2^order
 }
 
-// Calcula el orden necesario para un tamaño dado
+// Calcula el orden necesario para un tamaño dado: el bit más alto de size - 1 (bsr), más uno
 static uint8_t size_to_order(size_t size)
 {
-	// Incluir espacio para el header
-	size += sizeof(buddy_node_t);
-
-	uint8_t order      = MIN_ORDER;
-	size_t  block_size = order_to_size(order);
+	if (size > order_to_size(MAX_ORDER)) {
+		return 0xFF; // Indicar que no hay suficiente espacio
+	}
 
-	// Buscar el orden más pequeño que entre
-	while (block_size < size && order < MAX_ORDER) {
-		order++;
-		block_size = order_to_size(order);
+	if (size <= order_to_size(MIN_ORDER)) {
+		return MIN_ORDER;
 	}
 
+	uint8_t order = 64 - __builtin_clzll(size - 1);
 	if (order > MAX_ORDER) {
 		return 0xFF; // Indicar que no hay suficiente espacio
 	}
@@ -59,6 +66,12 @@ static uint8_t size_to_order(size_t size)
 	return order;
 }
 
+static inline uint8_t *info_of(memory_manager_ADT memory_manager, void *block)
+{
+	size_t offset = (char *)block - (char *)memory_manager->base_address;
+	return &memory_manager->block_info[offset >> MIN_ORDER];
+}
+
 // Calcula la dirección del buddy de un bloque
 static void *get_buddy_address(memory_manager_ADT memory_manager, void *block_addr, uint8_t order)
 {
@@ -85,6 +98,10 @@ remove_from_free_list(memory_manager_ADT memory_manager, buddy_node_t *node, uin
 		node->next->prev = node->prev;
 	}
 
+	if (memory_manager->free_lists[index] == NULL) {
+		memory_manager->free_orders &= ~(1u << index);
+	}
+
 	node->next = NULL;
 	node->prev = NULL;
 }
@@ -94,93 +111,65 @@ static void add_from_free_list(memory_manager_ADT memory_manager, buddy_node_t *
 {
 	uint8_t index = order - MIN_ORDER;
 
-	node->next  = memory_manager->free_lists[index];
-	node->prev  = NULL;
-	node->order = order;
-	node->free  = true;
+	node->next                     = memory_manager->free_lists[index];
+	node->prev                     = NULL;
+	*info_of(memory_manager, node) = order | BLOCK_FREE;
 
 	if (memory_manager->free_lists[index]) {
 		memory_manager->free_lists[index]->prev = node;
 	}
 
 	memory_manager->free_lists[index] = node;
+	memory_manager->free_orders |= 1u << index;
 }
 
-// Divide un bloque en dos buddies
-static buddy_node_t *split_block(memory_manager_ADT memory_manager, uint8_t order)
+// Saca de su lista un bloque libre del orden pedido. Si no hay, toma el del menor orden más grande
+// con bloques libres (un bit-scan sobre free_orders) y lo divide a la mitad hasta llegar al orden
+// pedido, dejando la mitad superior de cada división en la lista de su orden
+static buddy_node_t *take_block(memory_manager_ADT memory_manager, uint8_t order)
 {
-	if (order == MIN_ORDER) {
-		return NULL; // No se puede dividir más
-	}
-
-	if (order > MAX_ORDER || order < MIN_ORDER) {
-		return NULL; // Orden inválido
+	uint8_t  index     = order - MIN_ORDER;
+	uint32_t available = memory_manager->free_orders & (~0u << index);
+	if (available == 0) {
+		return NULL; // Sin memoria
 	}
 
-	uint8_t index = order - MIN_ORDER;
-
-	// Si no hay bloques de este orden, dividir uno más grande
-	if (memory_manager->free_lists[index] == NULL && order < MAX_ORDER) {
-		if (split_block(memory_manager, order + 1) == NULL) {
-			return NULL; // No hay bloques más grandes
-		}
-	}
+	uint8_t       found = __builtin_ctz(available);
+	buddy_node_t *block = memory_manager->free_lists[found];
+	remove_from_free_list(memory_manager, block, found + MIN_ORDER);
 
-	if (memory_manager->free_lists[index] == NULL) {
-		return NULL; // No hay bloques de este orden
+	while (found > index) {
+		found--;
+		uint8_t       half  = found + MIN_ORDER;
+		buddy_node_t *upper = (buddy_node_t *)((char *)block + order_to_size(half));
+		add_from_free_list(memory_manager, upper, half);
 	}
-
-	// Tomar el primer bloque de este orden
-	buddy_node_t *block = memory_manager->free_lists[index];
-	remove_from_free_list(memory_manager, block, order);
-
-	// Dividir en dos buddies de orden-1
-	uint8_t new_order = order - 1;
-	size_t  half_size = order_to_size(new_order);
-
-	// Primer buddy (el bloque original)
-	buddy_node_t *buddy1 = block;
-
-	// Segundo buddy (mitad superior)
-	buddy_node_t *buddy2 = (buddy_node_t *)((char *)block + half_size);
-
-	// Agregar ambos a la lista del orden inferior
-	add_from_free_list(memory_manager, buddy1, new_order);
-	add_from_free_list(memory_manager, buddy2, new_order);
-
-	return buddy1;
+	return block;
 }
 
-// Fusiona un bloque con su buddy si es posible
-static void coalesce(memory_manager_ADT memory_manager, buddy_node_t *block)
+// Fusiona un bloque recién liberado con su buddy mientras el buddy esté libre y entero (mismo
+// orden), y lo agrega a la lista del orden al que llegó
+static void coalesce(memory_manager_ADT memory_manager, buddy_node_t *block, uint8_t order)
 {
-	uint8_t order = block->order;
-
-	if (order >= MAX_ORDER) {
-		return; // Ya es el bloque más grande
-	}
-
-	// Buscar el buddy
-	void         *buddyAddr = get_buddy_address(memory_manager, block, order);
-	buddy_node_t *buddy     = (buddy_node_t *)buddyAddr;
+	while (order < MAX_ORDER) {
+		// Buscar el buddy: los bloques del final del heap pueden no tenerlo
+		buddy_node_t *buddy  = get_buddy_address(memory_manager, block, order);
+		size_t        offset = (char *)buddy - (char *)memory_manager->base_address;
+		if (offset + order_to_size(order) > memory_manager->total_size ||
+		    *info_of(memory_manager, buddy) != (order | BLOCK_FREE)) {
+			break; // No se puede fusionar
+		}
 
-	// Verificar si el buddy está libre y tiene el mismo orden
-	if (!buddy->free || buddy->order != order) {
-		return; // No se puede fusionar
+		// El bloque con dirección menor se convierte en el bloque fusionado; el otro deja
+		// de ser el comienzo de un bloque
+		remove_from_free_list(memory_manager, buddy, order);
+		buddy_node_t *upper             = (block < buddy) ? buddy : block;
+		block                           = (block < buddy) ? block : buddy;
+		*info_of(memory_manager, upper) = NOT_A_BLOCK;
+		order++;
 	}
 
-	// Eliminar ambos de sus listas
-	remove_from_free_list(memory_manager, block, order);
-	remove_from_free_list(memory_manager, buddy, order);
-
-	// El bloque con dirección menor se convierte en el bloque fusionado
-	buddy_node_t *merged = (block < buddy) ? block : buddy;
-
-	// Agregar a la lista del siguiente orden
-	add_from_free_list(memory_manager, merged, order + 1);
-
-	// Intentar fusionar recursivamente
-	coalesce(memory_manager, merged);
+	add_from_free_list(memory_manager, block, order);
 }
 
 memory_manager_ADT create_memory_manager(void *start_address, size_t size)
@@ -190,17 +179,33 @@ memory_manager_ADT create_memory_manager(void *start_address, size_t size)
 		return NULL;
 	}
 
-	// Colocar el CDT al inicio
+	// Colocar el CDT al inicio, seguido de block_info (un byte por bloque mínimo del resto) y
+	// de los bloques, desde una dirección alineada a BASE_ALIGN
 	memory_manager_ADT memory_manager = (memory_manager_ADT)start_address;
-	memory_manager->base_address = (char *)start_address + sizeof(struct memory_manager_CDT);
-	memory_manager->total_size   = size - sizeof(struct memory_manager_CDT);
+
+	char     *info  = (char *)start_address + sizeof(struct memory_manager_CDT);
+	size_t    count = (size - sizeof(struct memory_manager_CDT)) >> MIN_ORDER;
+	uintptr_t base  = ((uintptr_t)info + count + BASE_ALIGN - 1) & ~(BASE_ALIGN - 1);
+	uintptr_t end   = (uintptr_t)start_address + size;
+	if (base >= end) {
+		return NULL;
+	}
+
+	memory_manager->block_info   = (uint8_t *)info;
+	memory_manager->base_address = (void *)base;
+	memory_manager->total_size   = (end - base) & ~(order_to_size(MIN_ORDER) - 1);
+	for (size_t i = 0; i < count; i++) {
+		memory_manager->block_info[i] = NOT_A_BLOCK;
+	}
 	memory_manager->allocated_blocks = 0;
 	memory_manager->total_allocated  = 0;
+	memory_manager->lock             = 1;
 
 	// Inicializar listas libres
 	for (int i = 0; i < NUM_ORDERS; i++) {
 		memory_manager->free_lists[i] = NULL;
 	}
+	memory_manager->free_orders = 0;
 
 	// Crear bloques iniciales con la memoria disponible
 	size_t  remaining_size  = memory_manager->total_size;
@@ -218,7 +223,7 @@ memory_manager_ADT create_memory_manager(void *start_address, size_t size)
 
 		// Crear el bloque
 		buddy_node_t *node = (buddy_node_t *)current_address;
-		add_from_free_list(memory_manager, node, order); // ← Ahora pasa memory_manager
+		add_from_free_list(memory_manager, node, order);
 
 		current_address = (char *)current_address + block_size;
 		remaining_size -= block_size;
@@ -227,12 +232,8 @@ memory_manager_ADT create_memory_manager(void *start_address, size_t size)
 	return memory_manager;
 }
 
-void *alloc_memory(memory_manager_ADT memory_manager, size_t size)
+static void *alloc_block(memory_manager_ADT memory_manager, size_t size)
 {
-	if (memory_manager == NULL || size == 0) {
-		return NULL;
-	}
-
 	// Calcular el orden necesario
 	uint8_t order = size_to_order(size);
 
@@ -240,57 +241,66 @@ void *alloc_memory(memory_manager_ADT memory_manager, size_t size)
 		return NULL; // Demasiado grande
 	}
 
-	uint8_t index = order - MIN_ORDER;
-
-	// Si no hay bloques del orden exacto, dividir uno más grande
-	if (memory_manager->free_lists[index] == NULL && order < MAX_ORDER) {
-		if (split_block(memory_manager, order + 1) == NULL) {
-			return NULL; // Sin memoria
-		}
-	}
-
-	if (memory_manager->free_lists[index] == NULL) {
+	buddy_node_t *block = take_block(memory_manager, order);
+	if (block == NULL) {
 		return NULL; // Sin memoria
 	}
 
-	// Tomar el primer bloque del orden
-	buddy_node_t *block = memory_manager->free_lists[index];
-	remove_from_free_list(memory_manager, block, order);
-
 	// Marcar como ocupado
-	block->free  = false;
-	block->order = order;
+	*info_of(memory_manager, block) = order;
 
 	memory_manager->allocated_blocks++;
-	memory_manager->total_allocated += order_to_size(order) - sizeof(buddy_node_t);
+	memory_manager->total_allocated += order_to_size(order);
 
-	// Retornar puntero después del header
-	return (char *)block + sizeof(buddy_node_t);
+	// El bloque entero es del usuario
+	return block;
 }
 
-void free_memory(memory_manager_ADT memory_manager, void *ptr)
+static void free_block(memory_manager_ADT memory_manager, void *ptr)
 {
-	if (memory_manager == NULL || ptr == NULL) {
+	// Solo se liberan comienzos de bloques alocados: se ignoran punteros de afuera del heap,
+	// del medio de un bloque o ya liberados
+	char  *base   = memory_manager->base_address;
+	size_t offset = (char *)ptr - base;
+	if ((char *)ptr < base || offset >= memory_manager->total_size ||
+	    (offset & (order_to_size(MIN_ORDER) - 1)) != 0) {
 		return;
 	}
+	uint8_t info = *info_of(memory_manager, ptr);
+	if (info == NOT_A_BLOCK || (info & BLOCK_FREE)) {
+		return; // Double free o puntero inválido
+	}
+
+	memory_manager->allocated_blocks--;
+	memory_manager->total_allocated -= order_to_size(info);
 
-	// Obtener el bloque
-	buddy_node_t *block = (buddy_node_t *)((char *)ptr - sizeof(buddy_node_t));
+	// Fusionar con el buddy y agregar a la lista libre
+	coalesce(memory_manager, ptr, info);
+}
 
-	if (block->free) {
-		return; // Double free
+// alloc y free toman el lock del manager con interrupciones deshabilitadas: con varias CPUs
+// corriendo, dos llamadas concurrentes podrían partir o fusionar el mismo par de buddies
+void *alloc_memory(memory_manager_ADT memory_manager, size_t size)
+{
+	if (memory_manager == NULL || size == 0) {
+		return NULL;
 	}
 
-	// Marcar como libre
-	block->free = true;
-	memory_manager->allocated_blocks--;
-	memory_manager->total_allocated -= order_to_size(block->order) - sizeof(buddy_node_t);
+	uint64_t flags = acquire_lock_irqsave(&memory_manager->lock);
+	void    *ptr   = alloc_block(memory_manager, size);
+	release_lock_irqrestore(&memory_manager->lock, flags);
+	return ptr;
+}
 
-	// Agregar a la lista libre
-	add_from_free_list(memory_manager, block, block->order);
+void free_memory(memory_manager_ADT memory_manager, void *ptr)
+{
+	if (memory_manager == NULL || ptr == NULL) {
+		return;
+	}
 
-	// Intentar fusionar con el buddy
-	coalesce(memory_manager, block);
+	uint64_t flags = acquire_lock_irqsave(&memory_manager->lock);
+	free_block(memory_manager, ptr);
+	release_lock_irqrestore(&memory_manager->lock, flags);
 }
 
 mem_info_t get_mem_status(memory_manager_ADT memory_manager)
@@ -5,30 +5,54 @@
 #include <string.h>
 #include <stdbool.h>
 #include "naiveConsole.h"
+#include "synchro.h"
 
 #define MIN_BLOCK_SIZE 32       // Tamaño mínimo de bloque
 #define ALIGN_SIZE 8            // Alineación de memoria (8 bytes)
 #define MAGIC_NUMBER 0xDEADBEEF // Para detectar corrupción
 
-// Header de cada bloque de memoria. Es una lista doblemente enlazada.
+// Listas libres segregadas en dos niveles (TLSF): el primer nivel es la potencia de 2 del tamaño y
+// el segundo la divide en SL_COUNT rangos iguales. Un bitmap por nivel marca las listas no vacías,
+// así que encontrar un bloque libre de tamaño suficiente son dos bit-scans y no depende de cuántos
+// bloques haya en el heap. Los bloques menores a SMALL_BLOCK_SIZE van todos al primer nivel 0, en
+// rangos de ALIGN_SIZE.
+#define SL_SHIFT 4
+#define SL_COUNT (1 << SL_SHIFT)
+#define FL_SHIFT (SL_SHIFT + 3) // 3 = log2(ALIGN_SIZE)
+#define SMALL_BLOCK_SIZE (1 << FL_SHIFT)
+#define FL_MAX_SHIFT 26 // bloques de hasta 64 MB
+#define FL_COUNT (FL_MAX_SHIFT - FL_SHIFT + 1)
+
+// Header de cada bloque de memoria. Los bloques están contiguos: el siguiente empieza donde termina
+// este y prev_phys (boundary tag) apunta al anterior, así que liberar fusiona con los dos vecinos
+// sin recorrer nada. Mientras el bloque está libre, su espacio utilizable guarda los enlaces de su
+// lista libre (free_links).
 typedef struct mem_block {
-	size_t            size; // Tamaño del bloque (sin incluir header)
-	struct mem_block *next; // Siguiente bloque en la lista
-	struct mem_block *prev; // Bloque anterior
-	bool              free; // true si está libre, false si está ocupado
+	size_t            size;      // Tamaño del bloque (sin incluir header)
+	struct mem_block *prev_phys; // Bloque anterior en memoria (NULL en el primero)
+	bool              free;      // true si está libre, false si está ocupado
 	uint32_t magic; // Número mágico para verificación.  Al liberar (free_memory) se verifica
 	                // que block->magic == MAGIC_NUMBER antes de confiar en el puntero; si
 	                // alguien pasó una dirección que no proviene del gestor (o fue
 	                // sobrescrita), la comparación falla y se ignora la operación
 } mem_block;
 
+typedef struct free_links {
+	mem_block *next_free;
+	mem_block *prev_free;
+} free_links;
+
 // Estructura del Memory Manager (CDT)
 struct memory_manager_CDT {
-	void      *start_address;    // Dirección base de la memoria
-	size_t     total_size;       // Tamaño total
-	mem_block *first_block;      // Primer bloque de la lista
-	size_t     allocated_blocks; // Contador de bloques allocados
-	size_t     total_allocated;  // Total de bytes allocados
+	void      *start_address;                  // Dirección base de la memoria
+	size_t     total_size;                     // Tamaño total
+	mem_block *first_block;                    // Primer bloque en memoria
+	size_t     allocated_blocks;               // Contador de bloques allocados
+	size_t     total_allocated;                // Total de bytes allocados
+	lock_t     lock;                           // Serializa alloc/free entre CPUs (1 = libre)
+	uint32_t   fl_bitmap;                      // Primeros niveles con alguna lista no vacía
+	uint32_t   sl_bitmap[FL_COUNT];            // Listas no vacías de cada primer nivel
+	mem_block *free_lists[FL_COUNT][SL_COUNT]; // Bloques libres de cada rango
 };
 
 static memory_manager_ADT kernel_mm = NULL;
@@ -39,76 +63,170 @@ static size_t align(size_t size)
 	return (size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
 }
 
-// Divide un bloque si es muy grande
-static void split_block(mem_block *block, size_t size)
+static inline free_links *links_of(mem_block *block)
+{
+	return (free_links *)((char *)block + sizeof(mem_block));
+}
+
+// Bloque siguiente en memoria, o NULL si este es el último del heap
+static inline mem_block *next_phys(memory_manager_ADT memory_manager, mem_block *block)
+{
+	char *next = (char *)block + sizeof(mem_block) + block->size;
+	char *end  = (char *)memory_manager->start_address + memory_manager->total_size;
+	return next + sizeof(mem_block) <= end ? (mem_block *)next : NULL;
+}
+
+// Índice del bit más alto (bsr)
+static inline int highest_bit(size_t value)
+{
+	return 63 - __builtin_clzll(value);
+}
+
+// Lista a la que pertenece un bloque libre de ese tamaño
+static void mapping_insert(size_t size, int *fl, int *sl)
+{
+	if (size < SMALL_BLOCK_SIZE) {
+		*fl = 0;
+		*sl = size / (SMALL_BLOCK_SIZE / SL_COUNT);
+		return;
+	}
+	int bit = highest_bit(size);
+	*sl     = (size >> (bit - SL_SHIFT)) ^ SL_COUNT;
+	*fl     = bit - FL_SHIFT + 1;
+}
+
+// Primera lista cuyos bloques tienen todos al menos size bytes: redondea size al comienzo del rango
+// siguiente (salvo que ya esté justo en uno)
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+	if (size >= SMALL_BLOCK_SIZE) {
+		size += ((size_t)1 << (highest_bit(size) - SL_SHIFT)) - 1;
+	}
+	mapping_insert(size, fl, sl);
+}
+
+static void insert_free(memory_manager_ADT memory_manager, mem_block *block)
+{
+	int fl, sl;
+	mapping_insert(block->size, &fl, &sl);
+
+	free_links *links = links_of(block);
+	mem_block  *head  = memory_manager->free_lists[fl][sl];
+	links->next_free  = head;
+	links->prev_free  = NULL;
+	if (head != NULL) {
+		links_of(head)->prev_free = block;
+	}
+	memory_manager->free_lists[fl][sl] = block;
+	memory_manager->fl_bitmap |= 1u << fl;
+	memory_manager->sl_bitmap[fl] |= 1u << sl;
+}
+
+static void remove_free(memory_manager_ADT memory_manager, mem_block *block)
+{
+	int fl, sl;
+	mapping_insert(block->size, &fl, &sl);
+
+	free_links *links = links_of(block);
+	if (links->prev_free != NULL) {
+		links_of(links->prev_free)->next_free = links->next_free;
+	} else {
+		memory_manager->free_lists[fl][sl] = links->next_free;
+	}
+	if (links->next_free != NULL) {
+		links_of(links->next_free)->prev_free = links->prev_free;
+	}
+
+	if (memory_manager->free_lists[fl][sl] == NULL) {
+		memory_manager->sl_bitmap[fl] &= ~(1u << sl);
+		if (memory_manager->sl_bitmap[fl] == 0) {
+			memory_manager->fl_bitmap &= ~(1u << fl);
+		}
+	}
+}
+
+// Divide un bloque si es muy grande; el resto queda libre en su lista
+static void split_block(memory_manager_ADT memory_manager, mem_block *block, size_t size)
 {
 	if (block->size >= size + sizeof(mem_block) + MIN_BLOCK_SIZE) {
 		// Crear nuevo bloque con el espacio restante
 		mem_block *newBlock = (mem_block *)((char *)block + sizeof(mem_block) + size);
 		newBlock->size      = block->size - size - sizeof(mem_block);
-		newBlock->free      = true; // ACA
+		newBlock->free      = true;
 		newBlock->magic     = MAGIC_NUMBER;
-		newBlock->next      = block->next;
-		newBlock->prev      = block;
+		newBlock->prev_phys = block;
+		block->size         = size;
 
-		if (block->next != NULL) {
-			block->next->prev = newBlock;
+		mem_block *next = next_phys(memory_manager, newBlock);
+		if (next != NULL) {
+			next->prev_phys = newBlock;
 		}
-
-		block->next = newBlock;
-		block->size = size;
+		insert_free(memory_manager, newBlock);
 	}
 }
 
-static inline void coalesce_next(mem_block *block)
+// Absorbe a next (libre y fuera de su lista) en block
+static void absorb_next(memory_manager_ADT memory_manager, mem_block *block, mem_block *next)
 {
-	if (block == NULL) {
-		return;
-	}
-	mem_block *next = block->next;
-	if (next != NULL && next->free) {
-		block->size += sizeof(mem_block) + next->size;
-		block->next = next->next;
-		if (block->next != NULL) {
-			block->next->prev = block;
-		}
+	block->size += sizeof(mem_block) + next->size;
+	next->magic = 0; // su header queda adentro de block
+
+	mem_block *after = next_phys(memory_manager, block);
+	if (after != NULL) {
+		after->prev_phys = block;
 	}
 }
 
-static inline void coalesce_prev(mem_block *block)
+// Fusiona un bloque recién liberado con sus vecinos libres y lo pone en su lista
+static void coalesce_blocks(memory_manager_ADT memory_manager, mem_block *block)
 {
-	if (block == NULL)
-		return;
-	mem_block *prev = block->prev;
+	mem_block *next = next_phys(memory_manager, block);
+	if (next != NULL && next->free) {
+		remove_free(memory_manager, next);
+		absorb_next(memory_manager, block, next);
+	}
+
+	mem_block *prev = block->prev_phys;
 	if (prev != NULL && prev->free) {
-		prev->size += sizeof(mem_block) + block->size;
-		prev->next = block->next;
-		if (block->next != NULL) {
-			block->next->prev = prev;
-		}
+		remove_free(memory_manager, prev);
+		absorb_next(memory_manager, prev, block);
+		block = prev;
 	}
-}
 
-// Fusiona bloques libres adyacentes usando funciones auxiliares. TIENEN QUE ESTAR EN ESE ORDEN!
-static void coalesce_blocks(mem_block *block)
-{
-	coalesce_next(block);
-	coalesce_prev(block);
+	insert_free(memory_manager, block);
 }
 
-// Busca el primer bloque libre que tenga el tamaño suficiente (First Fit)
+// Saca de su lista un bloque libre de al menos size bytes (NULL si no hay)
 static mem_block *find_free_block(memory_manager_ADT memory_manager, size_t size)
 {
-	mem_block *current = memory_manager->first_block;
+	int fl, sl;
+	mapping_search(size, &fl, &sl);
+
+	// Primero un rango mayor o igual del mismo nivel; si no hay, el menor nivel más grande
+	uint32_t sl_map = fl < FL_COUNT ? memory_manager->sl_bitmap[fl] & (~0u << sl) : 0;
+	if (sl_map == 0) {
+		uint32_t fl_map = memory_manager->fl_bitmap & (~0u << (fl + 1));
+		if (fl_map != 0) {
+			fl     = __builtin_ctz(fl_map);
+			sl_map = memory_manager->sl_bitmap[fl];
+		}
+	}
 
-	while (current != NULL) {
-		if (current->free && current->size >= size && current->magic == MAGIC_NUMBER) {
-			return current;
+	mem_block *block = NULL;
+	if (sl_map != 0) {
+		block = memory_manager->free_lists[fl][__builtin_ctz(sl_map)];
+	} else {
+		// Los rangos redondeados no tienen nada: puede servir el primero del rango de size
+		// (por ejemplo, cuando se pide casi todo lo que queda libre)
+		mapping_insert(size, &fl, &sl);
+		block = fl < FL_COUNT ? memory_manager->free_lists[fl][sl] : NULL;
+		if (block == NULL || block->size < size) {
+			return NULL; // No hay bloque libre suficiente
 		}
-		current = current->next;
 	}
 
-	return NULL; // No hay bloque libre suficiente
+	remove_free(memory_manager, block);
+	return block;
 }
 
 memory_manager_ADT create_memory_manager(void *start_address, size_t size)
@@ -130,29 +248,40 @@ memory_manager_ADT create_memory_manager(void *start_address, size_t size)
 	memory_manager->total_size       = size;
 	memory_manager->allocated_blocks = 0;
 	memory_manager->total_allocated  = 0;
+	memory_manager->lock             = 1;
+	memory_manager->fl_bitmap        = 0;
+	for (int fl = 0; fl < FL_COUNT; fl++) {
+		memory_manager->sl_bitmap[fl] = 0;
+		for (int sl = 0; sl < SL_COUNT; sl++) {
+			memory_manager->free_lists[fl][sl] = NULL;
+		}
+	}
 
 	// Crear el primer bloque libre después del CDT
-	memory_manager->first_block =
-	        (mem_block *)((char *)start_address + sizeof(struct memory_manager_CDT));
-	memory_manager->first_block->size =
-	        size - sizeof(struct memory_manager_CDT) -
-	        sizeof(mem_block); // Resto del espacio del memory manager
-	memory_manager->first_block->free  = true;
-	memory_manager->first_block->next  = NULL;
-	memory_manager->first_block->prev  = NULL;
-	memory_manager->first_block->magic = MAGIC_NUMBER;
+	size_t     header_size = align(sizeof(struct memory_manager_CDT));
+	mem_block *first       = (mem_block *)((char *)start_address + header_size);
+
+	first->size                 = (size - header_size - sizeof(mem_block)) & ~(ALIGN_SIZE - 1);
+	first->free                 = true;
+	first->prev_phys            = NULL;
+	first->magic                = MAGIC_NUMBER;
+	memory_manager->first_block = first;
+	insert_free(memory_manager, first);
 
 	return memory_manager;
 }
 
-void *alloc_memory(memory_manager_ADT memory_manager, size_t size)
+static void *alloc_block(memory_manager_ADT memory_manager, size_t size)
 {
-	if (memory_manager == NULL || size == 0) {
+	if (size > memory_manager->total_size) {
 		return NULL;
 	}
 
-	// Alinear el tamaño
+	// Alinear el tamaño (un bloque libre tiene que poder guardar sus enlaces)
 	size = align(size);
+	if (size < MIN_BLOCK_SIZE) {
+		size = MIN_BLOCK_SIZE;
+	}
 
 	// Buscar un bloque libre
 	mem_block *block = find_free_block(memory_manager, size);
@@ -162,7 +291,7 @@ void *alloc_memory(memory_manager_ADT memory_manager, size_t size)
 	}
 
 	// Dividir el bloque si es necesario
-	split_block(block, size);
+	split_block(memory_manager, block, size);
 
 	// Marcar como ocupado
 	block->free = false;
@@ -173,12 +302,8 @@ void *alloc_memory(memory_manager_ADT memory_manager, size_t size)
 	return (char *)block + sizeof(mem_block);
 }
 
-void free_memory(memory_manager_ADT memory_manager, void *ptr)
+static void free_block(memory_manager_ADT memory_manager, void *ptr)
 {
-	if (memory_manager == NULL || ptr == NULL) {
-		return;
-	}
-
 	// Obtener el bloque desde el puntero
 	mem_block *block = (mem_block *)((char *)ptr - sizeof(mem_block));
 
@@ -199,7 +324,32 @@ void free_memory(memory_manager_ADT memory_manager, void *ptr)
 	memory_manager->total_allocated -= block->size;
 
 	// Fusionar con bloques adyacentes
-	coalesce_blocks(block);
+	coalesce_blocks(memory_manager, block);
+}
+
+// alloc y free toman el lock del manager con interrupciones deshabilitadas: con varias CPUs
+// corriendo, dos llamadas concurrentes podrían partir o fusionar el mismo bloque
+void *alloc_memory(memory_manager_ADT memory_manager, size_t size)
+{
+	if (memory_manager == NULL || size == 0) {
+		return NULL;
+	}
+
+	uint64_t flags = acquire_lock_irqsave(&memory_manager->lock);
+	void    *ptr   = alloc_block(memory_manager, size);
+	release_lock_irqrestore(&memory_manager->lock, flags);
+	return ptr;
+}
+
+void free_memory(memory_manager_ADT memory_manager, void *ptr)
+{
+	if (memory_manager == NULL || ptr == NULL) {
+		return;
+	}
+
+	uint64_t flags = acquire_lock_irqsave(&memory_manager->lock);
+	free_block(memory_manager, ptr);
+	release_lock_irqrestore(&memory_manager->lock, flags);
 }
 
 mem_info_t get_mem_status(memory_manager_ADT memory_manager)
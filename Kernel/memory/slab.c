@@ -0,0 +1,132 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "slab.h"
+#include "memory_manager.h"
+
+#define ALIGN_SIZE 8
+// Cada slab empieza con el puntero al siguiente slab del cache
+#define SLAB_HEADER_SIZE ALIGN_SIZE
+
+// Después de cada objeto va una palabra de control: mientras el objeto está libre es el siguiente
+// de la lista de libres (así no pisa el estado que dejó el constructor), y mientras está alocado
+// apunta al cache. slab_free la usa para descartar objetos ajenos o liberados dos veces.
+
+static slab_cache_t *caches; // caches registrados, para slab_get_info
+static lock_t        caches_lock = 1;
+
+static size_t align(size_t size)
+{
+	return (size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+}
+
+static void **control_word(slab_cache_t *cache, void *object)
+{
+	return (void **)((char *)object + cache->stride - sizeof(void *));
+}
+
+// Calcula la geometría del cache y lo registra (con el lock del cache tomado)
+static void setup_cache(slab_cache_t *cache)
+{
+	cache->stride = align(cache->object_size) + sizeof(void *);
+
+	size_t pages = 1;
+	while ((pages * SLAB_PAGE_SIZE - SLAB_HEADER_SIZE) / cache->stride < SLAB_MIN_OBJECTS) {
+		pages *= 2; // potencias de 2 para no desperdiciar medio bloque con el buddy
+	}
+	cache->slab_size = pages * SLAB_PAGE_SIZE;
+	cache->per_slab  = (cache->slab_size - SLAB_HEADER_SIZE) / cache->stride;
+
+	uint64_t flags = acquire_lock_irqsave(&caches_lock);
+	cache->next    = caches;
+	caches         = cache;
+	release_lock_irqrestore(&caches_lock, flags);
+}
+
+// Pide un slab nuevo y agrega sus objetos a la lista de libres (con el lock del cache tomado)
+static bool grow(slab_cache_t *cache)
+{
+	if (cache->stride == 0) {
+		setup_cache(cache);
+	}
+
+	char *slab = alloc_memory(get_kernel_memory_manager(), cache->slab_size);
+	if (slab == NULL) {
+		return false;
+	}
+	*(void **)slab = cache->slabs;
+	cache->slabs   = slab;
+
+	// De atrás para adelante, así la lista queda en orden de direcciones
+	char *objects = slab + SLAB_HEADER_SIZE;
+	for (uint32_t i = cache->per_slab; i > 0; i--) {
+		void *object = objects + (i - 1) * cache->stride;
+		if (cache->ctor != NULL) {
+			cache->ctor(object);
+		}
+		*control_word(cache, object) = cache->free_list;
+		cache->free_list             = object;
+	}
+	cache->capacity += cache->per_slab;
+	cache->slab_count++;
+	return true;
+}
+
+void *slab_alloc(slab_cache_t *cache)
+{
+	uint64_t flags = acquire_lock_irqsave(&cache->lock);
+
+	if (cache->free_list == NULL && !grow(cache)) {
+		release_lock_irqrestore(&cache->lock, flags);
+		return NULL;
+	}
+
+	void  *object    = cache->free_list;
+	void **control   = control_word(cache, object);
+	cache->free_list = *control;
+	*control         = cache;
+	cache->objects++;
+
+	release_lock_irqrestore(&cache->lock, flags);
+	return object;
+}
+
+void slab_free(slab_cache_t *cache, void *object)
+{
+	if (object == NULL || cache->stride == 0) {
+		return;
+	}
+
+	uint64_t flags   = acquire_lock_irqsave(&cache->lock);
+	void   **control = control_word(cache, object);
+	if (*control == cache) {
+		*control         = cache->free_list;
+		cache->free_list = object;
+		cache->objects--;
+	}
+	release_lock_irqrestore(&cache->lock, flags);
+}
+
+int slab_get_info(slab_info_t *buffer, int max_count)
+{
+	int           count = 0;
+	uint64_t      flags = acquire_lock_irqsave(&caches_lock);
+	slab_cache_t *cache = caches;
+
+	for (; cache != NULL && count < max_count; cache = cache->next) {
+		slab_info_t *info = &buffer[count++];
+		int          i    = 0;
+		for (; i < SLAB_NAME_LENGTH - 1 && cache->name[i] != '\0'; i++) {
+			info->name[i] = cache->name[i];
+		}
+		info->name[i]     = '\0';
+		info->object_size = cache->object_size;
+		info->objects     = cache->objects;
+		info->capacity    = cache->capacity;
+		info->slabs       = cache->slab_count;
+		info->slab_size   = cache->slab_size;
+	}
+
+	release_lock_irqrestore(&caches_lock, flags);
+	return count;
+}
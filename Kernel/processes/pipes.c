@@ -7,6 +7,7 @@
 #include "lib.h"
 #include "synchro.h"
 #include "queue.h"
+#include "slab.h"
 #include "video_driver.h"
 
 typedef struct pipe {
@@ -22,8 +23,9 @@ typedef struct pipe {
 	char write_sem[SEM_NAME_SIZE];
 } pipe_t;
 
-static pipe_t *pipes[MAX_PIPES] = {NULL};
-static queue_t free_indexes     = NULL;
+static pipe_t      *pipes[MAX_PIPES] = {NULL};
+static queue_t      free_indexes     = NULL;
+static slab_cache_t pipe_cache       = SLAB_CACHE("pipe", pipe_t, NULL);
 
 static int get_free_idx()
 {
@@ -49,20 +51,25 @@ static int get_idx_from_fd(int fd)
 	return (idx < 0 || idx >= MAX_PIPES) ? -1 : idx;
 }
 
-static pid_t pipe_find_process_by_fd(int fd, bool match_read_fd)
+// Los procesos de un pipeline son hermanos (hijos de la shell, o de init si corren en background):
+// alcanza con recorrer los hijos del padre
+static pid_t pipe_find_process_by_fd(PCB *parent, int fd, bool match_read_fd)
 {
-	for (pid_t pid = 0; pid <= MAX_PID; pid++) {
-		PCB *process = scheduler_get_process(pid);
-		if (process == NULL || process->status == PS_TERMINATED) {
+	if (parent == NULL) {
+		return NO_PID;
+	}
+
+	for (PCB *process = parent->children; process != NULL; process = process->sibling_next) {
+		if (process->status == PS_TERMINATED) {
 			continue;
 		}
 
 		if (match_read_fd) {
 			if (process->read_fd == fd) {
-				return pid;
+				return process->pid;
 			}
 		} else if (process->write_fd == fd) {
-			return pid;
+			return process->pid;
 		}
 	}
 	return NO_PID;
@@ -95,8 +102,7 @@ int create_pipe(int fds[2])
 		return -1;
 	}
 
-	memory_manager_ADT mm   = get_kernel_memory_manager();
-	pipe_t            *pipe = alloc_memory(mm, sizeof(pipe_t));
+	pipe_t *pipe = slab_alloc(&pipe_cache);
 	if (pipe == NULL) {
 		return -1;
 	}
@@ -119,7 +125,7 @@ int create_pipe(int fds[2])
 	strcat(pipe->read_sem, "r");
 	if (sem_open(pipe->read_sem, 0) < 0) {
 		pipes[idx] = NULL;
-		free_memory(mm, pipe);
+		slab_free(&pipe_cache, pipe);
 		return -1;
 	}
 
@@ -129,7 +135,7 @@ int create_pipe(int fds[2])
 	if (sem_open(pipe->write_sem, PIPE_BUFFER_SIZE) < 0) {
 		sem_close(pipe->read_sem);
 		pipes[idx] = NULL;
-		free_memory(mm, pipe);
+		slab_free(&pipe_cache, pipe);
 		return -1;
 	}
 
@@ -288,7 +294,10 @@ int read_pipe(int fd, char *buf, int count)
 			return i;
 		}
 
+		// Si se bloquea esperando datos, al despertarlo se lo promueve como interactivo
+		scheduler_set_io_wait(true);
 		sem_wait(pipe->read_sem);
+		scheduler_set_io_wait(false);
 
 		// volvemos a chequear por las dudas de que haya cerrado mientras estabamos
 		// bloqueados
@@ -338,8 +347,9 @@ void pipe_on_process_killed(pid_t victim)
 		return;
 	}
 
-	int victim_read_fd  = victim_process->read_fd;
-	int victim_write_fd = victim_process->write_fd;
+	int  victim_read_fd  = victim_process->read_fd;
+	int  victim_write_fd = victim_process->write_fd;
+	PCB *parent          = scheduler_get_process(victim_process->parent_pid);
 
 	for (int i = 0; i < MAX_PIPES; i++) {
 		pipe_t *pipe = pipes[i];
@@ -355,7 +365,7 @@ void pipe_on_process_killed(pid_t victim)
 		}
 
 		if (victim_is_reader) {
-			pid_t writer_pid = pipe_find_process_by_fd(pipe->write_fd, false);
+			pid_t writer_pid = pipe_find_process_by_fd(parent, pipe->write_fd, false);
 			if (writer_pid != NO_PID && writer_pid != victim &&
 			    pipe_process_is_alive(writer_pid)) {
 				scheduler_kill_process(writer_pid);
@@ -363,7 +373,7 @@ void pipe_on_process_killed(pid_t victim)
 		}
 
 		if (victim_is_writer) {
-			pid_t reader_pid = pipe_find_process_by_fd(pipe->read_fd, true);
+			pid_t reader_pid = pipe_find_process_by_fd(parent, pipe->read_fd, true);
 			if (reader_pid != NO_PID && reader_pid != victim &&
 			    pipe_process_is_alive(reader_pid)) {
 				scheduler_kill_process(reader_pid);
@@ -386,11 +396,9 @@ void destroy_pipe(int idx)
 		return;
 	}
 
-	memory_manager_ADT mm = get_kernel_memory_manager();
-
 	sem_close(pipe->read_sem);
 	sem_close(pipe->write_sem);
-	free_memory(mm, pipe);
+	slab_free(&pipe_cache, pipe);
 	pipes[idx] = NULL;
 
 	// Devolver el índice a la cola de libres
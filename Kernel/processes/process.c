@@ -7,17 +7,85 @@
 #include "scheduler.h"
 #include "interrupts.h"
 #include "pipes.h"
+#include "fpu.h"
+#include "bandwidth.h"
+#include "slab.h"
 
 extern void  *setup_initial_stack(void *caller, int pid, void *stack_pointer, void *rcx);
-static char **duplicate_argv(const char **argv, int argc, memory_manager_ADT mm);
+static char **pack_argv(PCB *p, const char **argv, int argc, memory_manager_ADT mm);
 static void   process_caller(int pid);
 static void
 init_pcb_base_fields(PCB *p, int pid, process_entry_t entry, const char *name, bool killable);
-static int  init_pcb_stack(PCB *p, memory_manager_ADT mm);
+static int  init_pcb_stack(PCB *p, uint64_t stack_size, memory_manager_ADT mm);
 static int  init_pcb_argv(PCB *p, int argc, const char **argv, memory_manager_ADT mm);
 static void init_pcb_file_descriptors(PCB *p, int fds[2]);
 static void free_pcb_argv(PCB *p, memory_manager_ADT mm);
 static void free_pcb_stack(PCB *p, memory_manager_ADT mm);
+static void *stack_alloc(uint64_t size, memory_manager_ADT mm);
+static void  stack_free(void *stack, uint64_t size, memory_manager_ADT mm);
+
+// Los PCBs salen de su cache de objetos: crear y destruir procesos no pasa por el memory manager
+// para el PCB
+static slab_cache_t pcb_cache = SLAB_CACHE("pcb", PCB, NULL);
+
+// Los stacks liberados quedan en un pool por tamaño (uno por potencia de 2 entre MIN_STACK_SIZE y
+// MAX_STACK_SIZE), enlazados por su primera palabra: un ciclo de crear y terminar procesos reusa el
+// mismo stack sin partir ni unir bloques del memory manager. Cada pool guarda hasta
+// STACK_POOL_LIMIT stacks; los que sobran vuelven al memory manager. Se usa con el lock del kernel.
+#define STACK_CLASSES 5 // 4, 8, 16, 32 y 64 KB
+#define STACK_POOL_LIMIT 16
+
+static void    *stack_pool[STACK_CLASSES];
+static uint32_t stack_pool_count[STACK_CLASSES];
+
+static int stack_class(uint64_t size)
+{
+	return __builtin_ctzll(size / MIN_STACK_SIZE);
+}
+
+static void *stack_alloc(uint64_t size, memory_manager_ADT mm)
+{
+	int   i     = stack_class(size);
+	void *stack = stack_pool[i];
+	if (stack == NULL) {
+		return alloc_memory(mm, size);
+	}
+
+	stack_pool[i] = *(void **)stack;
+	stack_pool_count[i]--;
+	return stack;
+}
+
+static void stack_free(void *stack, uint64_t size, memory_manager_ADT mm)
+{
+	int i = stack_class(size);
+	if (stack_pool_count[i] >= STACK_POOL_LIMIT) {
+		free_memory(mm, stack);
+		return;
+	}
+
+	*(void **)stack = stack_pool[i];
+	stack_pool[i]   = stack;
+	stack_pool_count[i]++;
+}
+
+// Tamaño real del stack pedido: potencia de 2 entre MIN_STACK_SIZE y MAX_STACK_SIZE, o 0 si es
+// demasiado grande
+static uint64_t stack_size_for(uint64_t requested)
+{
+	if (requested == 0) {
+		return PROCESS_STACK_SIZE;
+	}
+	if (requested > MAX_STACK_SIZE) {
+		return 0;
+	}
+
+	uint64_t size = MIN_STACK_SIZE;
+	while (size < requested) {
+		size <<= 1;
+	}
+	return size;
+}
 
 static void
 init_pcb_base_fields(PCB *p, int pid, process_entry_t entry, const char *name, bool killable)
@@ -26,20 +94,76 @@ init_pcb_base_fields(PCB *p, int pid, process_entry_t entry, const char *name, b
 	p->parent_pid = scheduler_get_current_pid();
 	strncpy(p->name, name, MAX_PROCESS_NAME_LENGTH - 1);
 	p->name[MAX_PROCESS_NAME_LENGTH - 1] = '\0';
+	p->children                          = NULL;
+	p->zombies                           = NULL;
+	p->sibling_next                      = NULL;
+	p->sibling_prev                      = NULL;
+	p->owner                             = p;
+	p->threads                           = NULL;
+	p->thread_arg                        = NULL;
+	p->joiner                            = NO_PID;
 	p->entry                             = entry;
 	p->return_value                      = 0;
 	p->waiting_on                        = NO_PID;
+	p->ticks_left                        = 0;
+	p->pi_priority                       = MIN_PRIORITY;
+	p->io_wait                           = false;
+	p->batch                             = false;
+	p->voluntary_switches                = 0;
+	p->involuntary_switches              = 0;
+	p->wakeups                           = 0;
+	p->ready_since                       = 0;
+	p->wait_total_ns                     = 0;
+	p->wait_max_ns                       = 0;
+	memset(p->wait_hist, 0, sizeof(p->wait_hist));
 	p->killable                          = killable;
+	p->rq_next                           = NULL;
+	p->rq_prev                           = NULL;
+	p->rq_level                          = 0;
+	p->on_rq                             = false;
+	p->vruntime                          = 0;
+	p->exec_start                        = 0;
+	p->rq_index                          = 0;
+	p->dl_next                           = NULL;
+	p->dl_period                         = 0;
+	p->dl_budget                         = 0;
+	p->dl_last_update                    = 0;
+	p->dl_missed                         = 0;
+	p->dl_done                           = false;
+	p->dl_miss_counted                   = false;
+	p->group                             = ROOT_GROUP;
+	p->bw_next                           = NULL;
+	p->bw_prev                           = NULL;
+	p->bw_parked                         = false;
+	p->sem_next                          = NULL;
+	p->sem_waiting                       = NULL;
+	p->timer_next                        = NULL;
+	p->timer_prev                        = NULL;
+	p->wake_tick                         = 0;
+	p->on_timer                          = false;
+	p->fpu_state                         = NULL;
+	p->fpu_alloc                         = NULL;
+	p->fpu_cpu                           = NO_CPU;
+	p->cpu                               = 0;
+	p->running_on                        = NO_CPU;
+	p->lock_depth                        = 1; // arranca saliendo de una interrupción
+	p->reap                              = false;
 }
 
-static int init_pcb_stack(PCB *p, memory_manager_ADT mm)
+static int init_pcb_stack(PCB *p, uint64_t stack_size, memory_manager_ADT mm)
 {
-	p->stack_base = alloc_memory(mm, PROCESS_STACK_SIZE);
+	p->stack_size = stack_size_for(stack_size);
+	if (p->stack_size == 0) {
+		return ERROR;
+	}
+	p->stack_base = stack_alloc(p->stack_size, mm);
 	if (p->stack_base == NULL) {
 		return ERROR;
 	}
-	p->stack_pointer = setup_initial_stack(
-	        &process_caller, p->pid, (char *)p->stack_base + PROCESS_STACK_SIZE, 0);
+	// Tope alineado a 16 menos el lugar de una dirección de retorno: process_caller arranca con
+	// el stack como si lo hubieran llamado con call (lo necesitan las instrucciones SSE alineadas)
+	uint64_t top     = ((uint64_t)p->stack_base + p->stack_size) & ~(uint64_t)0xF;
+	p->stack_pointer = setup_initial_stack(&process_caller, p->pid, (void *)(top - 8), 0);
 	return OK;
 }
 
@@ -47,7 +171,7 @@ static int init_pcb_argv(PCB *p, int argc, const char **argv, memory_manager_ADT
 {
 	p->argc = argc;
 	if (argc > 0 && argv != NULL) {
-		p->argv = duplicate_argv(argv, argc, mm);
+		p->argv = pack_argv(p, argv, argc, mm);
 		if (p->argv == NULL) {
 			return ERROR;
 		}
@@ -59,7 +183,7 @@ static int init_pcb_argv(PCB *p, int argc, const char **argv, memory_manager_ADT
 
 static void init_pcb_file_descriptors(PCB *p, int fds[2])
 {
-	p->open_fds = q_init();
+	memset(p->open_fds, 0, sizeof(p->open_fds));
 
 	if (fds == NULL) {
 		p->read_fd  = STDIN;
@@ -68,14 +192,48 @@ static void init_pcb_file_descriptors(PCB *p, int fds[2])
 		p->read_fd = fds[0];
 		if (fds[0] >= FIRST_FREE_FD) {
 			open_fd(fds[0]);
-			q_add(p->open_fds, fds[0]);
+			proc_fd_add(p, fds[0]);
 		}
 		p->write_fd = fds[1];
 		if (fds[1] >= FIRST_FREE_FD) {
 			open_fd(fds[1]);
-			q_add(p->open_fds, fds[1]);
+			proc_fd_add(p, fds[1]);
+		}
+	}
+}
+
+bool proc_fd_is_open(PCB *p, int fd)
+{
+	return fd >= 0 && fd < MAX_FDS && ((p->owner->open_fds[fd / 64] >> (fd % 64)) & 1);
+}
+
+void proc_fd_add(PCB *p, int fd)
+{
+	if (fd >= 0 && fd < MAX_FDS) {
+		p->owner->open_fds[fd / 64] |= 1ull << (fd % 64);
+	}
+}
+
+bool proc_fd_remove(PCB *p, int fd)
+{
+	if (!proc_fd_is_open(p, fd)) {
+		return false;
+	}
+	p->owner->open_fds[fd / 64] &= ~(1ull << (fd % 64));
+	return true;
+}
+
+int proc_fd_poll(PCB *p)
+{
+	uint64_t *open_fds = p->owner->open_fds;
+	for (int i = 0; i < FD_BITMAP_WORDS; i++) {
+		if (open_fds[i] != 0) {
+			int fd = i * 64 + __builtin_ctzll(open_fds[i]);
+			proc_fd_remove(p, fd);
+			return fd;
 		}
 	}
+	return -1;
 }
 
 PCB *proc_create(int             pid,
@@ -84,7 +242,8 @@ PCB *proc_create(int             pid,
                  const char    **argv,
                  const char     *name,
                  bool            killable,
-                 int             fds[2])
+                 int             fds[2],
+                 uint64_t        stack_size)
 {
 	if (!entry || !name || argc < 0) {
 		return NULL;
@@ -92,21 +251,21 @@ PCB *proc_create(int             pid,
 
 	memory_manager_ADT mm = get_kernel_memory_manager();
 
-	PCB *p = alloc_memory(mm, sizeof(PCB));
+	PCB *p = slab_alloc(&pcb_cache);
 	if (!p) {
 		return NULL;
 	}
 
 	init_pcb_base_fields(p, pid, entry, name, killable);
 
-	if (init_pcb_stack(p, mm) == ERROR) {
-		free_memory(mm, p);
+	if (init_pcb_stack(p, stack_size, mm) == ERROR) {
+		slab_free(&pcb_cache, p);
 		return NULL;
 	}
 
 	if (init_pcb_argv(p, argc, argv, mm) == ERROR) {
-		free_memory(mm, p->stack_base);
-		free_memory(mm, p);
+		stack_free(p->stack_base, p->stack_size, mm);
+		slab_free(&pcb_cache, p);
 		return NULL;
 	}
 
@@ -115,23 +274,55 @@ PCB *proc_create(int             pid,
 	return p;
 }
 
+PCB *proc_create_thread(int            pid,
+                        PCB           *owner,
+                        thread_entry_t entry,
+                        void          *arg,
+                        uint64_t       stack_size)
+{
+	if (!entry || !owner) {
+		return NULL;
+	}
+
+	memory_manager_ADT mm = get_kernel_memory_manager();
+
+	PCB *p = slab_alloc(&pcb_cache);
+	if (!p) {
+		return NULL;
+	}
+
+	// process_caller distingue a los hilos por owner y llama a entry con arg
+	init_pcb_base_fields(p, pid, (process_entry_t)entry, owner->name, owner->killable);
+	p->parent_pid = owner->pid;
+	p->owner      = owner;
+	p->thread_arg = arg;
+
+	if (init_pcb_stack(p, stack_size, mm) == ERROR) {
+		slab_free(&pcb_cache, p);
+		return NULL;
+	}
+
+	p->argc = 0;
+	p->argv = NULL;
+	memset(p->open_fds, 0, sizeof(p->open_fds));
+	p->read_fd  = owner->read_fd;
+	p->write_fd = owner->write_fd;
+
+	return p;
+}
+
 static void free_pcb_argv(PCB *p, memory_manager_ADT mm)
 {
-	if (p->argv != NULL) {
-		for (int i = 0; i < p->argc; i++) {
-			if (p->argv[i] != NULL) {
-				free_memory(mm, p->argv[i]);
-			}
-		}
+	if (p->argv != NULL && p->argv != (char **)p->argv_inline) {
 		free_memory(mm, p->argv);
-		p->argv = NULL;
 	}
+	p->argv = NULL;
 }
 
 static void free_pcb_stack(PCB *p, memory_manager_ADT mm)
 {
 	if (p->stack_base != NULL) {
-		free_memory(mm, p->stack_base);
+		stack_free(p->stack_base, p->stack_size, mm);
 		p->stack_base    = NULL;
 		p->stack_pointer = NULL;
 	}
@@ -147,57 +338,45 @@ void free_process_resources(PCB *p)
 
 	free_pcb_argv(p, mm);
 	free_pcb_stack(p, mm);
+	fpu_release(p);
 
-	q_destroy(p->open_fds);
-	p->open_fds = NULL;
-
-	// Liberar PCB
-	free_memory(mm, p);
+	// Devolver el PCB al cache
+	slab_free(&pcb_cache, p);
 }
 
-static char **duplicate_argv(const char **argv, int argc, memory_manager_ADT mm)
+// Copia argv en un solo bloque: los argc + 1 punteros seguidos de los strings. Si entra en el PCB
+// (argv_inline) no aloca nada; si no, es una sola alocación que se libera de una vez
+static char **pack_argv(PCB *p, const char **argv, int argc, memory_manager_ADT mm)
 {
-	// Caso argv vacío o NULL: crear argv minimal con solo NULL
-	if (argv == NULL || argc == 0 || (argc > 0 && argv[0] == NULL)) {
-		char **new_argv = alloc_memory(mm, sizeof(char *));
-		if (new_argv == NULL) {
-			return NULL;
+	size_t total = (argc + 1) * sizeof(char *);
+	for (int i = 0; i < argc; i++) {
+		if (argv[i] != NULL) {
+			total += strlen(argv[i]) + 1;
 		}
-		new_argv[0] = NULL;
-		return new_argv;
 	}
 
-	// Alocar array de punteros (argc + 1 para el NULL terminador)
-	char **new_argv = alloc_memory(mm, (argc + 1) * sizeof(char *));
-	if (new_argv == NULL) {
-		return NULL;
+	char **new_argv = (char **)p->argv_inline;
+	if (total > sizeof(p->argv_inline)) {
+		new_argv = alloc_memory(mm, total);
+		if (new_argv == NULL) {
+			return NULL;
+		}
 	}
 
-	// Copiar cada string
+	// Los strings van después del arreglo de punteros (terminado en NULL)
+	char *str = (char *)(new_argv + argc + 1);
 	for (int i = 0; i < argc; i++) {
 		if (argv[i] == NULL) {
 			new_argv[i] = NULL;
 			continue;
 		}
-
 		size_t len  = strlen(argv[i]) + 1;
-		new_argv[i] = alloc_memory(mm, len);
-
-		if (new_argv[i] == NULL) {
-			// Error: liberar todo lo alocado hasta ahora (ROLLBACK)
-			for (int j = 0; j < i; j++) {
-				if (new_argv[j] != NULL) {
-					free_memory(mm, new_argv[j]);
-				}
-			}
-			free_memory(mm, new_argv);
-			return NULL;
-		}
-
-		memcpy(new_argv[i], argv[i], len);
+		new_argv[i] = str;
+		memcpy(str, argv[i], len);
+		str += len;
 	}
-
 	new_argv[argc] = NULL;
+
 	return new_argv;
 }
 
@@ -210,8 +389,9 @@ static void process_caller(int pid)
 		return;
 	}
 
-	// Llamar a la función de entrada del proceso
-	int res = p->entry(p->argc, p->argv);
+	// Llamar a la función de entrada del proceso (o del hilo)
+	int res = proc_is_thread(p) ? ((thread_entry_t)p->entry)(p->thread_arg)
+	                            : p->entry(p->argc, p->argv);
 
 	// Cuando retorna, terminar el proceso
 	scheduler_exit_process(res);
@@ -4,29 +4,48 @@
 #include "scheduler.h"
 #include "process.h"
 #include "lib.h"
-#include "queue.h"
 #include "pipes.h"
 #include "interrupts.h"
 #include "video_driver.h"
 #include "../include/time.h"
 #include <stddef.h>
 #include "synchro.h"
+#include "smp.h"
+#include "runqueue.h"
+#include "deadline.h"
+#include "bandwidth.h"
+#include "fpu.h"
 
-extern void timer_tick();
+extern uint64_t read_tsc(void);
+extern void     context_switch(void **save_rsp, void *next_rsp);
+extern uint64_t _irq_save(void);
+extern void     _irq_restore(uint64_t flags);
 
 #define SHELL_ADDRESS ((void *)0x400000)
 
-static PCB    *processes[MAX_PROCESSES];
-static queue_t ready_queue[PRIORITY_COUNT] = {0};
-
-static pid_t    current_pid            = NO_PID;
-static uint8_t  process_count          = 0;
-static uint64_t total_cpu_ticks        = 0;
-static bool     force_reschedule       = false;
-static bool     scheduler_initialized  = false;
-static pid_t    foreground_process_pid = NO_PID;
-
-static PCB        *pick_next_process(void);
+// Tabla de procesos indexada por PID: arranca con INITIAL_PROCESS_TABLE lugares y se duplica
+// (hasta MAX_PROCESSES) cuando hace falta un PID que no entra. Los PIDs libres se buscan en un
+// bitmap, siempre el más bajo, así la tabla no crece mientras haya huecos.
+static PCB    **processes;
+static uint32_t table_size;
+static uint64_t pid_bitmap[PID_BITMAP_WORDS];
+static uint32_t pid_hint; // ninguna palabra del bitmap anterior a esta tiene PIDs libres
+
+// Las colas READY de cada CPU (y la política que decide quién corre) viven en sched/: cada CPU
+// elige de las suyas y, si se queda sin trabajo, le roba a la más cargada. Antes que ellas corren
+// los procesos de tiempo real de la CPU (deadline.h), que no migran. Todo el estado del
+// scheduler se modifica con el lock del kernel tomado.
+
+static uint32_t      process_count          = 0;
+static uint64_t      total_cpu_ticks        = 0;
+static bool          scheduler_initialized  = false;
+static pid_t         foreground_process_pid = NO_PID;
+static sched_stats_t sched_stats            = {0};
+static void         *discarded_rsp; // contextos que no se retoman (arranque, procesos terminados)
+
+static PCB        *pick_next_process(cpu_t *cpu);
+static void        make_ready(PCB *p);
+static bool        should_preempt(cpu_t *cpu, PCB *current);
 static void        reparent_children_to_init(pid_t pid);
 static int         init(int argc, char **argv);
 static int         scheduler_add_init();
@@ -34,17 +53,344 @@ static inline bool pid_is_valid(pid_t pid);
 static void        cleanup_all_processes(void);
 static int         create_shell();
 static void        close_open_fds(PCB *p);
-static void        apply_aging(void);
+static void        link_child(PCB *p);
+static void        unlink_child(PCB *p);
+static void        notify_parent(PCB *child);
+static void        link_thread(PCB *t);
+static void        unlink_thread(PCB *t);
+static void        finish_thread(PCB *t, int64_t ret_value);
+static void        kill_threads(PCB *owner);
 
 static inline bool pid_is_valid(pid_t pid)
 {
-	return pid >= 0 && pid <= MAX_PID;
+	return pid >= 0 && (uint32_t)pid < table_size;
+}
+
+static void claim_pid(pid_t pid)
+{
+	pid_bitmap[pid / 64] |= 1ull << (pid % 64);
+}
+
+static void release_pid(pid_t pid)
+{
+	pid_bitmap[pid / 64] &= ~(1ull << (pid % 64));
+	if ((uint32_t)pid / 64 < pid_hint) {
+		pid_hint = pid / 64;
+	}
+}
+
+// Duplica la tabla de procesos hasta que entre el PID
+static int grow_process_table(pid_t pid)
+{
+	uint32_t new_size = table_size;
+	while (new_size <= (uint32_t)pid) {
+		new_size *= 2;
+	}
+	if (new_size > MAX_PROCESSES) {
+		return -1;
+	}
+
+	memory_manager_ADT mm        = get_kernel_memory_manager();
+	PCB              **new_table = alloc_memory(mm, new_size * sizeof(PCB *));
+	if (new_table == NULL) {
+		return -1;
+	}
+	if (rq_reserve(new_size) != 0) {
+		free_memory(mm, new_table);
+		return -1;
+	}
+	memcpy(new_table, processes, table_size * sizeof(PCB *));
+	memset(new_table + table_size, 0, (new_size - table_size) * sizeof(PCB *));
+
+	free_memory(mm, processes);
+	processes  = new_table;
+	table_size = new_size;
+	return 0;
+}
+
+// Devuelve el PID libre más bajo (agrandando la tabla si no entra) o NO_PID
+static pid_t alloc_pid(void)
+{
+	for (uint32_t word = pid_hint; word < PID_BITMAP_WORDS; word++) {
+		if (pid_bitmap[word] == ~0ull) {
+			continue;
+		}
+		pid_hint  = word;
+		pid_t pid = word * 64 + __builtin_ctzll(~pid_bitmap[word]);
+		if ((uint32_t)pid >= table_size && grow_process_table(pid) != 0) {
+			return NO_PID;
+		}
+		claim_pid(pid);
+		return pid;
+	}
+	pid_hint = PID_BITMAP_WORDS;
+	return NO_PID;
+}
+
+// Agrega el proceso a la lista de hijos (o de hijos terminados) de su padre
+static void link_child(PCB *p)
+{
+	PCB *parent = pid_is_valid(p->parent_pid) ? processes[p->parent_pid] : NULL;
+	if (parent == NULL) {
+		return;
+	}
+
+	PCB **head      = (p->status == PS_TERMINATED) ? &parent->zombies : &parent->children;
+	p->sibling_prev = NULL;
+	p->sibling_next = *head;
+	if (*head != NULL) {
+		(*head)->sibling_prev = p;
+	}
+	*head = p;
+}
+
+// Saca al proceso de la lista de su padre en la que esté
+static void unlink_child(PCB *p)
+{
+	PCB *parent = pid_is_valid(p->parent_pid) ? processes[p->parent_pid] : NULL;
+	if (parent == NULL) {
+		return;
+	}
+
+	if (p->sibling_prev != NULL) {
+		p->sibling_prev->sibling_next = p->sibling_next;
+	} else if (parent->children == p) {
+		parent->children = p->sibling_next;
+	} else if (parent->zombies == p) {
+		parent->zombies = p->sibling_next;
+	}
+	if (p->sibling_next != NULL) {
+		p->sibling_next->sibling_prev = p->sibling_prev;
+	}
+	p->sibling_next = NULL;
+	p->sibling_prev = NULL;
+}
+
+// El hijo terminó (ya está en PS_TERMINATED) y su padre no es init: pasa a la lista de hijos
+// terminados y, si el padre lo estaba esperando (o esperaba a cualquiera), se lo despierta
+static void notify_parent(PCB *child)
+{
+	PCB *parent = processes[child->parent_pid];
+	if (parent == NULL) {
+		return;
+	}
+
+	unlink_child(child);
+	link_child(child);
+
+	if (parent->status == PS_BLOCKED &&
+	    (parent->waiting_on == child->pid || parent->waiting_on == ANY_CHILD)) {
+		scheduler_unblock_process(parent->pid);
+	}
+}
+
+// Agrega el hilo a la lista de hilos de su proceso
+static void link_thread(PCB *t)
+{
+	PCB *owner      = t->owner;
+	t->sibling_prev = NULL;
+	t->sibling_next = owner->threads;
+	if (owner->threads != NULL) {
+		owner->threads->sibling_prev = t;
+	}
+	owner->threads = t;
+}
+
+static void unlink_thread(PCB *t)
+{
+	if (t->sibling_prev != NULL) {
+		t->sibling_prev->sibling_next = t->sibling_next;
+	} else {
+		t->owner->threads = t->sibling_next;
+	}
+	if (t->sibling_next != NULL) {
+		t->sibling_next->sibling_prev = t->sibling_prev;
+	}
+	t->sibling_next = NULL;
+	t->sibling_prev = NULL;
+}
+
+// El hilo terminó (ya se soltó de lo que esperaba): queda en la lista de su proceso hasta el
+// join y, si alguien lo estaba esperando, se lo despierta. Sus fds son los del proceso: no se
+// cierran.
+static void finish_thread(PCB *t, int64_t ret_value)
+{
+	rq_remove(t);
+	t->status       = PS_TERMINATED;
+	t->return_value = ret_value;
+
+	PCB *joiner = pid_is_valid(t->joiner) ? processes[t->joiner] : NULL;
+	if (joiner != NULL && joiner->status == PS_BLOCKED && joiner->waiting_on == t->pid) {
+		scheduler_unblock_process(joiner->pid);
+	}
+}
+
+// El proceso termina: sus hilos (que usan sus fds) terminan con él, tengan join o no. Si lo mató
+// uno de sus hilos, ese hilo se separa del proceso y se remueve al final de la syscall.
+static void kill_threads(PCB *owner)
+{
+	PCB *current = this_cpu()->current;
+	while (owner->threads != NULL) {
+		PCB *t = owner->threads;
+		if (t->status != PS_TERMINATED) {
+			reparent_children_to_init(t->pid);
+			remove_process_from_all_semaphore_queues(t->pid);
+			sleep_cancel(t);
+			dl_detach(t);
+			bw_detach(t);
+			t->status = PS_TERMINATED;
+		}
+		if (t == current) {
+			unlink_thread(t);
+			t->owner = t;
+		} else {
+			scheduler_remove_process(t->pid);
+		}
+	}
+}
+
+// El proceso pasa a READY: empieza a contar cuánto espera hasta correr
+static inline void start_wait(PCB *p)
+{
+	p->ready_since = clock_ns();
+}
+
+// El proceso va a correr: suma la espera a sus estadísticas y a su histograma log2 (en us)
+static void end_wait(PCB *p)
+{
+	if (p->ready_since == 0) {
+		return;
+	}
+
+	uint64_t wait  = clock_ns() - p->ready_since;
+	uint64_t us    = wait / 1000;
+	int      index = (us > 0) ? 63 - __builtin_clzll(us) : 0;
+	if (index >= WAIT_HIST_BUCKETS) {
+		index = WAIT_HIST_BUCKETS - 1;
+	}
+
+	p->wait_hist[index]++;
+	p->wait_total_ns += wait;
+	if (wait > p->wait_max_ns) {
+		p->wait_max_ns = wait;
+	}
+	p->ready_since = 0;
+}
+
+// CPU sin trabajo propio: un AP en su contexto idle o el BSP corriendo init
+static bool cpu_is_idle(int cpu_id)
+{
+	PCB *current = smp_get_cpu(cpu_id)->current;
+	return current == NULL || current->pid == INIT_PID;
+}
+
+// Devuelve la CPU (distinta de self) con más procesos esperando en sus colas, o NO_CPU si todas
+// tienen las colas vacías
+static int busiest_cpu(int self)
+{
+	int      busiest = NO_CPU;
+	uint32_t max     = 0;
+	for (int i = 0; i < smp_cpu_count(); i++) {
+		if (i != self && rq_count(i) > max) {
+			max     = rq_count(i);
+			busiest = i;
+		}
+	}
+	return busiest;
+}
+
+// Saca de la cola de la CPU el próximo proceso a correr. Los que elige de un grupo que gastó su
+// cuota quedan estacionados hasta el próximo período del grupo.
+static PCB *pick_from_queue(int cpu)
+{
+	PCB *p;
+	while ((p = rq_pick(cpu)) != NULL && bw_throttled(p)) {
+		bw_park(p);
+	}
+	return p;
+}
+
+// Saca de la CPU victim el proceso que correría a continuación y lo pasa a la CPU self (sin
+// encolarlo). NULL si en victim solo quedaban procesos sin cuota.
+static PCB *steal_process(int victim, int self)
+{
+	PCB *p = pick_from_queue(victim);
+	if (p != NULL) {
+		rq_migrate(p, self);
+		sched_stats.migrations++;
+	}
+	return p;
+}
+
+// Balanceo periódico: si otra CPU tiene al menos dos procesos esperando más que esta, se trae uno
+static void balance_load(int self)
+{
+	int victim = busiest_cpu(self);
+	if (victim != NO_CPU && rq_count(victim) >= rq_count(self) + 2) {
+		PCB *p = steal_process(victim, self);
+		if (p != NULL) {
+			rq_enqueue(p);
+		}
+	}
+}
+
+// CPU en la que encolar un proceso que pasa a READY: la suya si está ociosa; si no, una CPU
+// ociosa sin nada encolado (así no espera a que la dueña desaloje a su proceso actual)
+static int select_cpu(PCB *p)
+{
+	if (cpu_is_idle(p->cpu)) {
+		return p->cpu;
+	}
+	for (int i = 0; i < smp_cpu_count(); i++) {
+		if (cpu_is_idle(i) && rq_count(i) == 0) {
+			return i;
+		}
+	}
+	return p->cpu;
+}
+
+// Encola un proceso que pasa a READY y avisa a la CPU elegida si tiene que replanificar. Un
+// proceso de tiempo real no se encola: su CPU lo ve en su lista apenas está READY.
+static void make_ready(PCB *p)
+{
+	start_wait(p);
+
+	int cpu = p->cpu;
+	if (!dl_is_member(p)) {
+		cpu = select_cpu(p);
+		if (cpu != p->cpu) {
+			rq_migrate(p, cpu);
+		}
+		rq_enqueue(p);
+	}
+
+	cpu_t *target = smp_get_cpu(cpu);
+	if (target == this_cpu()) {
+		// Si esta CPU estaba en idle con el tick apagado, el próximo tick elige al proceso
+		tick_restart();
+	} else if (cpu_is_idle(cpu) || should_preempt(target, target->current)) {
+		smp_send_resched(p->cpu);
+	}
+}
+
+// Vuelve a encolar los procesos estacionados que liberó sched/bandwidth.c (lista por bw_next). La
+// espera en READY sigue contando desde antes de estacionarlos.
+static void make_ready_list(PCB *list)
+{
+	while (list != NULL) {
+		PCB     *next  = list->bw_next;
+		uint64_t since = list->ready_since;
+		list->bw_next  = NULL;
+		make_ready(list);
+		list->ready_since = since;
+		list              = next;
+	}
 }
 
 static void close_open_fds(PCB *p)
 {
-	while (!q_is_empty(p->open_fds)) {
-		int fd = q_poll(p->open_fds);
+	int fd;
+	while ((fd = proc_fd_poll(p)) != -1) {
 		close_fd(fd);
 	}
 }
@@ -89,7 +435,7 @@ int scheduler_set_foreground_process(pid_t pid)
 static int create_shell()
 {
 	PCB *pcb_shell = proc_create(
-	        SHELL_PID, (process_entry_t)SHELL_ADDRESS, 0, NULL, "shell", false, NULL);
+	        SHELL_PID, (process_entry_t)SHELL_ADDRESS, 0, NULL, "shell", false, NULL, 0);
 	if (pcb_shell == NULL) {
 		return -1;
 	}
@@ -98,14 +444,12 @@ static int create_shell()
 	pcb_shell->status             = PS_READY;
 	pcb_shell->cpu_ticks          = 0;
 	pcb_shell->last_tick          = ticks_elapsed();
+	pcb_shell->cpu                = this_cpu()->id;
 	processes[SHELL_PID]          = pcb_shell;
 	process_count++;
-	if (!q_add(ready_queue[pcb_shell->effective_priority], SHELL_PID)) {
-		processes[SHELL_PID] = NULL;
-		process_count--;
-		free_process_resources(pcb_shell);
-		return -1;
-	}
+	claim_pid(SHELL_PID);
+	link_child(pcb_shell);
+	make_ready(pcb_shell);
 	return 0;
 }
 
@@ -115,7 +459,8 @@ static int scheduler_add_init()
 		return -1;
 	}
 
-	PCB *pcb_init = proc_create(INIT_PID, (process_entry_t)init, 0, NULL, "init", false, NULL);
+	PCB *pcb_init =
+	        proc_create(INIT_PID, (process_entry_t)init, 0, NULL, "init", false, NULL, 0);
 	if (pcb_init == NULL) {
 		return -1;
 	}
@@ -125,9 +470,11 @@ static int scheduler_add_init()
 	pcb_init->status             = PS_READY;
 	pcb_init->cpu_ticks          = 0;
 	pcb_init->last_tick          = 0;
+	pcb_init->cpu                = BSP_CPU; // init es el proceso idle del BSP
 
 	processes[INIT_PID] = pcb_init;
 	process_count++;
+	claim_pid(INIT_PID);
 	return 0;
 }
 
@@ -137,32 +484,34 @@ int init_scheduler(void)
 		return 0;
 	}
 
-	// Inicializar array de procesos
-	for (int i = 0; i < MAX_PROCESSES; i++) {
-		processes[i] = NULL;
+	// Inicializar la tabla de procesos y el bitmap de PIDs
+	processes = alloc_memory(get_kernel_memory_manager(), INITIAL_PROCESS_TABLE * sizeof(PCB *));
+	if (processes == NULL) {
+		return -1;
 	}
+	table_size = INITIAL_PROCESS_TABLE;
+	memset(processes, 0, table_size * sizeof(PCB *));
+	memset(pid_bitmap, 0, sizeof(pid_bitmap));
+	pid_hint = 0;
 
-	// inicializamos las queues
-	for (int i = MAX_PRIORITY; i <= MIN_PRIORITY; i++) {
-		ready_queue[i] = q_init();
-		if (ready_queue[i] == NULL) {
-			return -1;
-		}
+	rq_init();
+	if (rq_reserve(INITIAL_PROCESS_TABLE) != 0) {
+		free_memory(get_kernel_memory_manager(), processes);
+		return -1;
 	}
+	dl_init();
+	bw_init();
+	memset(&sched_stats, 0, sizeof(sched_stats));
 
-	process_count    = 0;
-	total_cpu_ticks  = 0;
-	force_reschedule = false;
-	current_pid      = NO_PID; // NO le pongo INIT_PID porque el que lo tiene que elegir es el
-	                           // schedule la primera vez que se llama.
+	process_count   = 0;
+	total_cpu_ticks = 0;
+	// El current del BSP queda en NULL (no INIT_PID) porque el que lo tiene que elegir es el
+	// schedule la primera vez que se llama.
 	// Sino, la primera llamada a scheudule va a tratar a init como current y va a pisar su
-	// stack_pointer con prev_rsp
+	// stack_pointer con el contexto de arranque
+	this_cpu()->current = NULL;
 
 	if (scheduler_add_init() != 0) {
-		for (int i = MAX_PRIORITY; i <= MIN_PRIORITY; i++) {
-			q_destroy(ready_queue[i]);
-		}
-
 		return -1;
 	}
 
@@ -170,176 +519,400 @@ int init_scheduler(void)
 	return 0;
 }
 
-void *schedule(void *prev_rsp)
+// Registra el costo (en ciclos de TSC) de una decisión de scheduling
+static void account_sched_cost(uint64_t start_cycles)
 {
-	if (!scheduler_initialized) {
-		return prev_rsp;
+	uint64_t cycles = read_tsc() - start_cycles;
+	sched_stats.ticks++;
+	sched_stats.total_cycles += cycles;
+	sched_stats.last_cycles = cycles;
+	if (cycles > sched_stats.max_cycles) {
+		sched_stats.max_cycles = cycles;
 	}
+}
 
-	PCB *current = (pid_is_valid(current_pid)) ? processes[current_pid] : NULL;
+// Devuelve true si hay un proceso listo que debería desalojar al actual: uno de tiempo real con
+// un deadline más próximo, el que decida la política de la cola de esta CPU, o cualquiera (propio
+// o para robar) si el actual es init (idle). A un proceso de tiempo real solo lo desaloja otro.
+static bool should_preempt(cpu_t *cpu, PCB *current)
+{
+	if (dl_should_preempt(cpu->id, current)) {
+		return true;
+	}
+	if (dl_is_member(current)) {
+		return false;
+	}
+	if (bw_throttled(current)) {
+		return true; // su grupo gastó la cuota del período
+	}
+	if (current->pid == INIT_PID) {
+		return rq_count(cpu->id) > 0 || busiest_cpu(cpu->id) != NO_CPU;
+	}
+	return rq_should_preempt(cpu->id, current);
+}
 
-	if (current) {
-		current->stack_pointer = prev_rsp; // actualiza el rsp del proceso que estuvo
-		                                   // corriendo hasta ahora en su pcb
+// Le cobra al proceso el tiempo que corrió desde la última vez a su clase de scheduling
+static void update_current(PCB *current, uint64_t now)
+{
+	if (dl_is_member(current)) {
+		dl_update_current(current, now);
+	} else if (current->pid != INIT_PID) {
+		rq_update_current(current);
+	}
+}
 
-		current->cpu_ticks++;
-		total_cpu_ticks++;
+// Saca de la CPU al proceso actual (si lo hay), elige el próximo y cambia de contexto. Vuelve
+// cuando el contexto que la llamó vuelve a ser elegido, quizás en otra CPU (si el proceso
+// terminó, nunca). Se llama con el lock del kernel tomado y las interrupciones deshabilitadas.
+static void switch_process(cpu_t *cpu, bool slice_expired, uint64_t start_cycles)
+{
+	PCB     *current  = cpu->current;
+	bool     was_idle = current == NULL && cpu->in_idle;
+	void   **save_rsp = &discarded_rsp;
+	uint64_t now      = ticks_elapsed();
 
-		// Cuando un proceso deja de correr (por cualquier razón), vuelve a su prioridad
-		// base (pierde cualquier promoción temporal por aging)
-		current->effective_priority = current->priority;
+	if (current) {
+		current->lock_depth = cpu->lock_depth;
+		update_current(current, now);
 
-		// Con quantum de 1 tick, siempre forzamos reschedule después de cada tick
-		// (a menos que el proceso ya no esté RUNNING por otra razón)
+		// La política ajusta su nivel según cómo dejó la CPU
+		if (current->pid != INIT_PID && !dl_is_member(current)) {
+			rq_put_prev(current, slice_expired);
+		}
 
 		if (current->status == PS_RUNNING) {
 			// Si el status es RUNNING, cambiar a READY
 			// Si fue bloqueado, terminado o matado, el status ya se cambió en otras
 			// funciones
 			current->status = PS_READY;
+			if (current->pid != INIT_PID) {
+				start_wait(current);
+			}
 		}
 
-		if (current->status == PS_READY && current->pid != INIT_PID) {
-			// Agregar a la cola correspondiente a su prioridad efectiva (que ya fue
-			// reseteada a priority)
-			queue_t target_queue = ready_queue[current->effective_priority];
-			if (!q_add(target_queue, current->pid)) {
-				current->status  = PS_RUNNING;
-				force_reschedule = false;
-				return prev_rsp;
-			}
+		if (current->status == PS_READY && current->pid != INIT_PID && !dl_is_member(current)) {
+			// Agregar a la cola correspondiente a su prioridad efectiva en esta misma CPU
+			rq_enqueue(current);
 		}
+		current->running_on = NO_CPU;
+
+		// Si terminó, su PCB se libera antes de dejar su stack: no se guarda su contexto
+		if (!current->reap) {
+			save_rsp = &current->stack_pointer;
+		}
+	} else if (was_idle) {
+		// Se interrumpió el contexto idle de un AP: guardarlo para volver cuando no haya
+		// nada para correr
+		cpu->idle_lock_depth = cpu->lock_depth;
+		save_rsp             = &cpu->idle_rsp;
 	}
 
-	// Aplicar aging cada N ticks
-	if (total_cpu_ticks % AGING_CHECK_INTERVAL == 0) {
-		apply_aging();
+	PCB *next = pick_next_process(cpu);
+
+	// Si no hay otro proceso listo, el BSP usa el proceso init como fallback
+	if (!next && cpu->id == BSP_CPU) {
+		next = processes[INIT_PID];
 	}
 
-	// Si el proceso actual tiene que cambiar:
-	PCB *next = pick_next_process();
+	if (next != current) {
+		fpu_switch(cpu, current, next);
+	}
+
+	// Proceso que terminó (o fue matado) mientras corría en esta CPU: ya no se va a volver a su
+	// stack, así que se pueden liberar sus recursos (se sigue usando su stack hasta el cambio
+	// de contexto, sin alocar memoria en el medio)
+	if (current != NULL && current->reap) {
+		free_process_resources(current);
+	}
+
+	if ((!next || next->pid == INIT_PID) && dl_count(cpu->id) == 0 && !bw_pending()) {
+		// Sin trabajo: no hace falta el tick periódico hasta que llegue un proceso (salvo
+		// que haya procesos de tiempo real o de un grupo sin cuota esperando su período)
+		tick_stop();
+	} else {
+		tick_restart();
+	}
 
-	// Si no hay otro proceso listo, usar el proceso init como fallback
+	void *next_rsp;
 	if (!next) {
-		next = processes[INIT_PID];
+		// AP sin trabajo: vuelve a su contexto idle
+		cpu->current    = NULL;
+		cpu->in_idle    = true;
+		cpu->lock_depth = cpu->idle_lock_depth;
+		next_rsp        = cpu->idle_rsp;
+	} else {
+		// Cuando un proceso va a correr:
+		// Actualizar su last_tick y darle el turno que le asigne la política
+		end_wait(next);
+		next->last_tick  = total_cpu_ticks;
+		next->ticks_left = dl_is_member(next) ? dl_set_running(next, now)
+		                                      : rq_set_running(cpu->id, next);
+		next->status     = PS_RUNNING;
+		next->running_on = cpu->id;
+
+		cpu->current    = next;
+		cpu->in_idle    = false;
+		cpu->lock_depth = next->lock_depth;
+		next_rsp        = next->stack_pointer;
 	}
 
-	// Cuando un proceso va a correr:
-	// Actualizar su last_tick para el control de aging
-	next->last_tick = total_cpu_ticks;
+	account_sched_cost(start_cycles);
 
-	current_pid      = next->pid;
-	next->status     = PS_RUNNING;
-	force_reschedule = false;
-	return next->stack_pointer;
+	// Sigue el mismo contexto (el proceso volvió a ser elegido o el AP sigue en idle)
+	if (next == current && (current != NULL || was_idle)) {
+		return;
+	}
+	context_switch(save_rsp, next_rsp);
 }
 
-// Devuelve null si no hay proceso listo para correr en ninguna cola
-// Recorre las colas de mayor prioridad (0) a menor (PRIORITY_COUNT-1)
-static PCB *pick_next_process(void)
+void schedule(void)
 {
-	if (!scheduler_initialized || process_count == 0) {
-		return NULL;
+	if (!scheduler_initialized) {
+		return;
 	}
 
-	// Recorrer las colas por orden de prioridad
-	for (int priority = MAX_PRIORITY; priority <= MIN_PRIORITY; priority++) {
-		if (q_is_empty(ready_queue[priority])) {
-			continue;
+	uint64_t start_cycles = read_tsc();
+
+	cpu_t *cpu     = this_cpu();
+	PCB   *current = cpu->current;
+
+	cpu->ticks++;
+	if ((current != NULL && current->pid == INIT_PID) || (current == NULL && cpu->in_idle)) {
+		cpu->idle_wakeups++;
+	}
+
+	uint64_t now = ticks_elapsed();
+	dl_tick(cpu->id, now);
+	make_ready_list(bw_tick(now));
+
+	bool slice_expired = false;
+	if (current) {
+		current->cpu_ticks++;
+		total_cpu_ticks++;
+		update_current(current, now);
+		if (current->pid != INIT_PID && !dl_is_member(current)) {
+			bw_charge(current);
 		}
 
-		// Buscar un proceso válido en esta cola de prioridad
-		while (!q_is_empty(ready_queue[priority])) {
-			pid_t next_pid = (pid_t)q_poll(ready_queue[priority]);
-			if (!pid_is_valid(next_pid)) {
-				continue;
+		if (current->status == PS_RUNNING) {
+			// El proceso sigue corriendo hasta agotar su quantum, salvo que se haya
+			// despertado alguien de mayor prioridad
+			if (current->ticks_left > 0) {
+				current->ticks_left--;
 			}
-			PCB *candidate = processes[next_pid];
-			if (candidate != NULL && candidate->status == PS_READY) {
-				return candidate;
+
+			if (current->ticks_left > 0 && !should_preempt(cpu, current)) {
+				if (cpu->ticks % AGING_CHECK_INTERVAL == 0) {
+					rq_aging(cpu->id, cpu->ticks);
+				}
+				if (current->pid == INIT_PID && dl_count(cpu->id) == 0 &&
+				    !bw_pending()) {
+					tick_stop(); // el one-shot no despertó a nadie: sigue sin trabajo
+				}
+				account_sched_cost(start_cycles);
+				return;
 			}
-			// Si el proceso ya no está listo, seguimos buscando en esta cola
+
+			current->involuntary_switches++;
+			slice_expired = current->ticks_left == 0;
+		} else {
+			// Lo bloquearon o mataron desde otra CPU y todavía no atendió la IPI
+			current->voluntary_switches++;
 		}
+	} else if (cpu->in_idle) {
+		cpu->idle_ticks++;
 	}
 
-	return NULL;
+	// Aplicar aging cada N ticks de esta CPU (el contador global puede saltearse el múltiplo)
+	if (cpu->ticks % AGING_CHECK_INTERVAL == 0) {
+		rq_aging(cpu->id, cpu->ticks);
+	}
+
+	if (cpu->ticks % BALANCE_INTERVAL == 0) {
+		balance_load(cpu->id);
+	}
+
+	switch_process(cpu, slice_expired, start_cycles);
 }
 
-// Aplica aging: promueve procesos que llevan mucho tiempo sin correr
-static void apply_aging(void)
+// IPI de otra CPU: un proceso de esta CPU fue bloqueado o matado, o se encoló trabajo nuevo.
+// No es un tick: no se cobra al proceso ni cuenta para su quantum.
+void scheduler_handle_ipi(void)
 {
-	// Recorrer desde MIN_PRIORITY hasta MAX_PRIORITY+1 (no promovemos desde MAX_PRIORITY)
-	for (int i = MIN_PRIORITY; i > MAX_PRIORITY; i--) {
-		if (q_is_empty(ready_queue[i])) {
-			continue;
-		}
+	if (!scheduler_initialized) {
+		return;
+	}
 
-		q_to_begin(ready_queue[i]);
-		while (q_has_next(ready_queue[i])) {
-			pid_t pid = q_next(ready_queue[i]);
-			PCB  *p   = processes[pid];
+	uint64_t start_cycles = read_tsc();
 
-			// Si el proceso no existe o no cumple el threshold, continuar
-			if (p == NULL) {
-				continue;
-			}
+	cpu_t *cpu     = this_cpu();
+	PCB   *current = cpu->current;
 
-			// Verificar si hace mucho que no corre (comparar con total_cpu_ticks)
-			if (total_cpu_ticks - p->last_tick >= AGING_THRESHOLD) {
-				// Promover: remover de esta cola y agregar a la de mayor prioridad
-				q_remove_current(ready_queue[i]);
-				p->effective_priority = i - 1;  // Subir un nivel de prioridad
-				p->last_tick = total_cpu_ticks; // Actualizar last_tick para evitar
-				                                // promociones repetidas
-				q_add(ready_queue[i - 1], pid);
-			}
+	if (current == NULL && !cpu->in_idle) {
+		return;
+	}
+	if (current != NULL && current->status == PS_RUNNING && !should_preempt(cpu, current)) {
+		return;
+	}
+
+	if (current == NULL || current->pid == INIT_PID) {
+		cpu->idle_wakeups++;
+	}
+	if (current != NULL) {
+		// Si lo bloquearon o mataron desde otra CPU, cuenta como que dejó la CPU
+		// voluntariamente
+		if (current->status == PS_RUNNING) {
+			current->involuntary_switches++;
+		} else {
+			current->voluntary_switches++;
 		}
 	}
+
+	switch_process(cpu, false, start_cycles);
+}
+
+// Se llama al entrar a cada syscall: si otra CPU bloqueó o mató al proceso mientras corría
+// código de usuario, no se ejecuta la syscall hasta que vuelva a ser elegido (si lo mataron,
+// no vuelve)
+void scheduler_syscall_entry(void)
+{
+	PCB *current = this_cpu()->current;
+	if (current != NULL && current->status != PS_RUNNING) {
+		scheduler_force_reschedule();
+	}
+}
+
+// Devuelve null si no hay proceso listo para correr en la cola de esta CPU ni para robarle a otra
+static PCB *pick_next_process(cpu_t *cpu)
+{
+	if (!scheduler_initialized) {
+		return NULL;
+	}
+
+	// Los procesos de tiempo real van antes que las colas de la política
+	PCB *candidate = dl_pick(cpu->id);
+	if (candidate != NULL) {
+		return candidate;
+	}
+
+	candidate = pick_from_queue(cpu->id);
+	if (candidate != NULL) {
+		return candidate;
+	}
+
+	// Sin trabajo propio: robar de la CPU con más procesos esperando
+	int victim = busiest_cpu(cpu->id);
+	if (victim == NO_CPU) {
+		return NULL;
+	}
+	return steal_process(victim, cpu->id);
 }
 
 // Agrega el proceso al array de procesos y a la cola READY
-int scheduler_add_process(
-        process_entry_t entry, int argc, const char **argv, const char *name, int fds[2])
+int scheduler_add_process(process_entry_t entry,
+                          int             argc,
+                          const char    **argv,
+                          const char     *name,
+                          int             fds[2],
+                          uint64_t        stack_size)
 {
-	if (!scheduler_initialized || process_count >= MAX_PROCESSES) {
+	if (!scheduler_initialized) {
 		return -1;
 	}
 
-	// Buscar primer PID libre
-	pid_t pid = NO_PID;
-	for (int i = 0; i < MAX_PROCESSES; i++) {
-		if (processes[i] == NULL) {
-			pid = i;
-			break;
-		}
-	}
-	if (!pid_is_valid(pid)) {
+	pid_t pid = alloc_pid();
+	if (pid == NO_PID) {
 		return -1;
 	}
 
-	PCB *process = proc_create(pid, entry, argc, argv, name, true, fds);
+	PCB *process = proc_create(pid, entry, argc, argv, name, true, fds, stack_size);
 	if (process == NULL) {
+		release_pid(pid);
 		return -1;
 	}
 
-	// Inicializar campos relacionados con scheduling
+	// Inicializar campos relacionados con scheduling (el grupo se hereda del padre)
+	PCB *parent                 = this_cpu()->current;
+	process->group              = parent != NULL ? parent->group : ROOT_GROUP;
+	process->batch              = parent != NULL && parent->batch;
 	process->priority           = DEFAULT_PRIORITY; // Asignar prioridad por defecto
 	process->effective_priority = DEFAULT_PRIORITY; // Inicialmente igual a priority
 	process->status             = PS_READY;
 	process->cpu_ticks          = 0;
 	process->last_tick          = total_cpu_ticks;
+	process->cpu                = this_cpu()->id;
 
 	processes[pid] = process;
 	process_count++;
+	link_child(process);
+	make_ready(process);
+
+	return pid;
+}
 
-	if (!q_add(ready_queue[process->effective_priority], pid)) {
-		processes[pid] = NULL;
-		process_count--;
-		free_process_resources(process);
+// Crea un hilo del proceso actual: arranca con la prioridad y la clase del hilo que lo crea
+int scheduler_add_thread(thread_entry_t entry, void *arg, uint64_t stack_size)
+{
+	PCB *creator = scheduler_initialized ? this_cpu()->current : NULL;
+	if (creator == NULL) {
 		return -1;
 	}
 
-	return pid;
+	pid_t tid = alloc_pid();
+	if (tid == NO_PID) {
+		return -1;
+	}
+
+	PCB *thread = proc_create_thread(tid, creator->owner, entry, arg, stack_size);
+	if (thread == NULL) {
+		release_pid(tid);
+		return -1;
+	}
+
+	thread->group              = creator->group;
+	thread->batch              = creator->batch;
+	thread->priority           = creator->priority;
+	thread->effective_priority = creator->priority;
+	thread->status             = PS_READY;
+	thread->cpu_ticks          = 0;
+	thread->last_tick          = total_cpu_ticks;
+	thread->cpu                = this_cpu()->id;
+
+	processes[tid] = thread;
+	process_count++;
+	link_thread(thread);
+	make_ready(thread);
+
+	return tid;
+}
+
+// Bloquea al hilo actual hasta que termine el hilo tid (de su mismo proceso) y lo libera. Un hilo
+// admite un solo join.
+int scheduler_join_thread(pid_t tid, int *status)
+{
+	if (!scheduler_initialized || !pid_is_valid(tid) || processes[tid] == NULL) {
+		return -1;
+	}
+
+	PCB *current = this_cpu()->current;
+	PCB *thread  = processes[tid];
+	if (!proc_is_thread(thread) || thread == current || thread->owner != current->owner ||
+	    thread->joiner != NO_PID) {
+		return -1;
+	}
+
+	thread->joiner = current->pid;
+	while (thread->status != PS_TERMINATED) {
+		current->waiting_on = tid;
+		scheduler_block_process(current->pid);
+	}
+	current->waiting_on = NO_PID;
+
+	if (status != NULL) {
+		*status = thread->return_value;
+	}
+	scheduler_remove_process(tid);
+	return 0;
 }
 
 int scheduler_remove_process(pid_t pid)
@@ -354,19 +927,33 @@ int scheduler_remove_process(pid_t pid)
 	}
 
 	// Remover de la cola de procesos listos para correr
-	if (process->status == PS_READY || process->status == PS_RUNNING) {
-		// Buscar en la cola correspondiente a su prioridad efectiva
-		q_remove(ready_queue[process->effective_priority], process->pid);
+	rq_remove(process);
+	dl_detach(process);
+	bw_detach(process);
+	if (proc_is_thread(process)) {
+		// Su tiempo de CPU queda en la cuenta del proceso
+		unlink_thread(process);
+		process->owner->cpu_ticks += process->cpu_ticks;
+	} else {
+		unlink_child(process);
 	}
 
-	// Remover del array
+	// Remover de la tabla
 	processes[pid] = NULL;
 	process_count--;
-
-	// Si estábamos ejecutando este proceso, forzar reschedule
-	if (current_pid == pid) {
-		current_pid = -1;
-		scheduler_force_reschedule();
+	release_pid(pid);
+	process->status = PS_TERMINATED;
+
+	// Si una CPU todavía lo está corriendo (esta, en un exit, u otra si lo mataron mientras
+	// corría), su stack sigue en uso: se libera en el próximo schedule() de esa CPU
+	if (process->running_on != NO_CPU) {
+		process->reap = true;
+		if (process->running_on == this_cpu()->id) {
+			scheduler_force_reschedule();
+		} else {
+			smp_send_resched(process->running_on);
+		}
+		return 0;
 	}
 
 	// Liberar recursos del proceso
@@ -383,46 +970,156 @@ int scheduler_set_priority(pid_t pid, uint8_t new_priority)
 		return -1;
 	}
 
-	PCB    *process                = processes[pid];
-	uint8_t old_priority           = process->priority;
-	uint8_t old_effective_priority = process->effective_priority;
+	PCB    *process      = processes[pid];
+	uint8_t old_priority = process->priority;
 
 	// Si la prioridad no cambia, no hacer nada
 	if (old_priority == new_priority) {
 		return 0;
 	}
 
-	// Si el proceso está READY, hay que moverlo de una cola a otra
-	if (process->status == PS_READY) {
+	// Si el proceso está READY, hay que moverlo de una cola a otra (uno de tiempo real no está
+	// en ninguna)
+	if (process->status == PS_READY && !dl_is_member(process) && !process->bw_parked) {
 		// Remover de la cola actual (usa effective_priority porque ahí está realmente)
-		q_remove(ready_queue[old_effective_priority], pid);
+		rq_remove(process);
 
-		// Cambiar ambas prioridades
+		// Cambiar ambas prioridades (sin perder la que haya heredado por un mutex)
 		process->priority           = new_priority;
 		process->effective_priority = new_priority;
-
-		// Actualizar last_tick: el cambio manual de prioridad cuenta como "atención" del
-		// scheduler
-		process->last_tick = total_cpu_ticks;
+		rq_set_inherited(process, process->pi_priority);
 
 		// Agregar a la nueva cola
-		if (!q_add(ready_queue[new_priority], pid)) {
-			// Si falla, volver a poner en la cola antigua
-			process->priority           = old_priority;
-			process->effective_priority = old_effective_priority;
-			q_add(ready_queue[old_effective_priority], pid);
-			return -1;
-		}
+		rq_enqueue(process);
 	} else {
-		// Si está RUNNING, BLOCKED o TERMINATED, solo cambiar la prioridad base
-		// effective_priority se reseteará cuando vuelva a correr
+		// Si está RUNNING, BLOCKED o TERMINATED no está en ninguna cola: arranca en el
+		// nivel de su nueva prioridad
 		process->priority           = new_priority;
 		process->effective_priority = new_priority;
+		rq_set_inherited(process, process->pi_priority);
 	}
 
 	return 0;
 }
 
+int scheduler_set_inherited_priority(pid_t pid, uint8_t priority)
+{
+	if (!scheduler_initialized || !pid_is_valid(pid) || processes[pid] == NULL ||
+	    priority > MIN_PRIORITY) {
+		return -1;
+	}
+
+	PCB *process = processes[pid];
+	if (process->pi_priority == priority || process->pid == INIT_PID || dl_is_member(process)) {
+		return 0;
+	}
+
+	// Si está READY se lo cambia de cola: la política ubica a los encolados según su prioridad
+	bool queued = process->on_rq;
+	rq_remove(process);
+	rq_set_inherited(process, priority);
+	if (queued) {
+		rq_enqueue(process);
+	}
+
+	return 0;
+}
+
+int scheduler_set_batch(pid_t pid, bool batch)
+{
+	if (!scheduler_initialized || !pid_is_valid(pid) || processes[pid] == NULL ||
+	    pid == INIT_PID) {
+		return -1;
+	}
+
+	PCB *process = processes[pid];
+	if (process->batch == batch) {
+		return 0;
+	}
+
+	// Lo que corrió hasta ahora se cobra en la clase anterior, y si está READY se lo cambia de
+	// cola (uno de tiempo real o estacionado no está en ninguna)
+	if (process->running_on != NO_CPU && !dl_is_member(process)) {
+		rq_update_current(process);
+	}
+	bool queued = process->on_rq;
+	rq_remove(process);
+	process->batch = batch;
+	if (process->running_on == NO_CPU) {
+		process->ticks_left = 0; // el próximo turno es el de su clase nueva
+	}
+	if (queued) {
+		rq_enqueue(process);
+	}
+	return 0;
+}
+
+static void set_process_group(PCB *process, int group)
+{
+	bool was_parked = process->bw_parked;
+	bw_detach(process);
+	process->group = group;
+
+	// Si estaba estacionado porque su grupo no tenía cuota, en el grupo nuevo puede correr
+	if (was_parked) {
+		make_ready_list(process);
+	}
+}
+
+int scheduler_set_group(pid_t pid, int group)
+{
+	if (!scheduler_initialized || !pid_is_valid(pid) || processes[pid] == NULL ||
+	    !bw_valid_group(group)) {
+		return -1;
+	}
+
+	// Los hilos comparten el grupo de su proceso: se cambia el de todos
+	PCB *owner = processes[pid]->owner;
+	set_process_group(owner, group);
+	for (PCB *t = owner->threads; t != NULL; t = t->sibling_next) {
+		set_process_group(t, group);
+	}
+	return 0;
+}
+
+int scheduler_set_group_quota(int group, uint32_t quota, uint32_t period)
+{
+	if (!scheduler_initialized) {
+		return -1;
+	}
+
+	PCB *released;
+	if (bw_set_quota(group, quota, period, ticks_elapsed(), &released) != 0) {
+		return -1;
+	}
+	make_ready_list(released);
+	return 0;
+}
+
+int scheduler_get_groups(group_info_t *buffer, int max_count)
+{
+	if (!scheduler_initialized || buffer == NULL || max_count <= 0) {
+		return -1;
+	}
+
+	group_info_t info[MAX_GROUPS];
+	bw_get_info(info);
+	for (uint32_t i = 0; i < table_size; i++) {
+		if (processes[i] != NULL) {
+			info[processes[i]->group].processes++;
+		}
+	}
+
+	// Solo los grupos en uso: con procesos, con cuota o que alguna vez corrieron
+	int count = 0;
+	for (int i = 0; i < MAX_GROUPS && count < max_count; i++) {
+		if (info[i].processes > 0 || info[i].quota > 0 || info[i].total_ticks > 0) {
+			buffer[count++] = info[i];
+		}
+	}
+	return count;
+}
+
 int scheduler_get_priority(pid_t pid)
 {
 	if (!scheduler_initialized || !pid_is_valid(pid) || processes[pid] == NULL) {
@@ -434,22 +1131,43 @@ int scheduler_get_priority(pid_t pid)
 
 void scheduler_force_reschedule(void)
 {
-	if (scheduler_initialized) {
-		force_reschedule = true;
-		timer_tick();
+	if (!scheduler_initialized) {
+		return;
+	}
+
+	// Se puede llamar desde una syscall, desde una interrupción o desde process_caller (sin el
+	// lock ni interrupciones deshabilitadas): se entra como lo haría una interrupción
+	uint64_t flags = _irq_save();
+	kernel_lock();
+
+	uint64_t start_cycles = read_tsc();
+	cpu_t   *cpu          = this_cpu();
+	if (cpu->current != NULL) {
+		cpu->current->voluntary_switches++;
 	}
+	switch_process(cpu, false, start_cycles);
+
+	// Puede volver en otra CPU: kernel_unlock usa la profundidad de la CPU en la que sigue
+	kernel_unlock();
+	_irq_restore(flags);
 }
 
 int scheduler_get_current_pid(void)
 {
 	if (scheduler_initialized) {
-		return current_pid;
+		PCB *current = this_cpu()->current;
+		return current != NULL ? current->pid : NO_PID;
 	}
 	return -1;
 }
 
+// Para un proceso de tiempo real, ceder la CPU marca el fin del trabajo del período
 void scheduler_yield(void)
 {
+	PCB *current = scheduler_initialized ? this_cpu()->current : NULL;
+	if (current != NULL && dl_is_member(current)) {
+		dl_job_done(current);
+	}
 	scheduler_force_reschedule();
 }
 
@@ -472,9 +1190,16 @@ int scheduler_kill_process(pid_t pid)
 		return -4; // Process is protected (init or shell)
 	}
 
+	// Guardarlo antes: si el padre es init, el PCB se libera acá mismo
+	bool running_here = killed_process == this_cpu()->current;
+	int  running_on   = killed_process->running_on;
+
 	reparent_children_to_init(killed_process->pid);
 
 	remove_process_from_all_semaphore_queues(killed_process->pid);
+	sleep_cancel(killed_process);
+	dl_detach(killed_process);
+	bw_detach(killed_process);
 
 	if (pid == foreground_process_pid) {
 		foreground_process_pid = SHELL_PID;
@@ -482,35 +1207,43 @@ int scheduler_kill_process(pid_t pid)
 		        killed_process->pid); // matamos el foreground group si estaba pipeado
 	}
 
+	// Sus hilos terminan con él (un hilo no tiene hilos propios)
+	kill_threads(killed_process);
+
 	killed_process->status       = PS_TERMINATED;
 	killed_process->return_value = KILLED_RET_VALUE;
 
-	// cierra los fds abiertos
-	close_open_fds(killed_process);
+	// cierra los fds abiertos (los de un hilo son los de su proceso)
+	if (!proc_is_thread(killed_process)) {
+		close_open_fds(killed_process);
+	}
 
-	if (killed_process->parent_pid == INIT_PID) {
+	if (proc_is_thread(killed_process)) {
+		finish_thread(killed_process, KILLED_RET_VALUE); // queda para el join
+	} else if (killed_process->parent_pid == INIT_PID) {
 		scheduler_remove_process(killed_process->pid);
 	} else { // si el padre no es init, no vamos a eliminarlo porque su padre podria hacerle un
 		 // wait
 		// Lo sacamos de la cola de procesos ready para que no vuelva a correr PERO NO  del
 		// array de procesos (para que el padre pueda acceder a su ret_value)
-		if (killed_process->status == PS_READY || killed_process->status == PS_RUNNING) {
-			q_remove(ready_queue[killed_process->effective_priority],
-			         killed_process->pid);
-		}
+		rq_remove(killed_process);
 		killed_process->status =
 		        PS_TERMINATED; // Le cambio el estado despues de hacer el dequeue o sino no
 		                       // va a entrar en la condición del if
 		killed_process->return_value = KILLED_RET_VALUE;
-		PCB *parent                  = processes[killed_process->parent_pid];
 
-		if (parent != NULL && parent->status == PS_BLOCKED &&
-		    parent->waiting_on == killed_process->pid) {
-			scheduler_unblock_process(parent->pid);
-		}
+		notify_parent(killed_process);
 	}
-	if (pid == current_pid) {
+	if (running_here) {
 		scheduler_yield();
+	} else if (running_on != NO_CPU) {
+		smp_send_resched(running_on); // que deje de correrlo ya, no en su próximo tick
+	}
+
+	// Lo mató uno de sus hilos, que terminó con él (kill_threads): no vuelve
+	PCB *current = this_cpu()->current;
+	if (current != NULL && current->status == PS_TERMINATED) {
+		scheduler_remove_process(current->pid);
 	}
 	return 0;
 }
@@ -527,16 +1260,19 @@ int scheduler_block_process(pid_t pid)
 		return -1;
 	}
 
-	// Remover de cola READY (si está ahí)
-	if (process->status == PS_READY || process->status == PS_RUNNING) {
-		q_remove(ready_queue[process->effective_priority], process->pid);
-	}
+	// Remover de cola READY (si está ahí). Si estaba esperando para correr, esa espera no
+	// termina corriendo: no se cuenta
+	rq_remove(process);
+	bw_detach(process);
+	process->ready_since = 0;
 
 	process->status = PS_BLOCKED;
 
-	// Si es el proceso actual, forzar reschedule
-	if (pid == current_pid) {
+	// Si es el proceso actual, forzar reschedule; si está corriendo en otra CPU, avisarle
+	if (process == this_cpu()->current) {
 		scheduler_force_reschedule();
+	} else if (process->running_on != NO_CPU) {
+		smp_send_resched(process->running_on);
 	}
 
 	return 0;
@@ -554,37 +1290,41 @@ int scheduler_unblock_process(pid_t pid)
 	}
 
 	process->status = PS_READY;
+	process->wakeups++;
 
-	// Al desbloquearse, el proceso vuelve a su prioridad base
-	// (por si fue promovido por aging mientras esperaba ser seleccionado, antes de bloquearse)
-	process->effective_priority = process->priority;
-
-	// Actualizar last_tick: el tiempo bloqueado no cuenta para aging
-	// El proceso debe esperar en READY para acumular tiempo y ser promovido
+	// Si esperaba teclado o un pipe la política lo trata como interactivo
+	rq_wakeup(process, process->io_wait);
 	process->last_tick = total_cpu_ticks;
 
-	// Agregar a la cola correspondiente a su prioridad efectiva
-	if (!q_add(ready_queue[process->effective_priority], pid)) {
-		process->status = PS_BLOCKED;
-		return -1;
-	}
+	// Agregar a la cola correspondiente a su prioridad efectiva (en una CPU ociosa si la hay)
+	make_ready(process);
 
 	return 0;
 }
 
+void scheduler_set_io_wait(bool waiting)
+{
+	PCB *current = scheduler_initialized ? this_cpu()->current : NULL;
+	if (current != NULL) {
+		current->io_wait = waiting;
+	}
+}
+
 static void cleanup_all_processes(void)
 {
 	if (!scheduler_initialized) {
 		return;
 	}
 
-	for (int i = 0; i < MAX_PROCESSES; i++) {
+	for (uint32_t i = 0; i < table_size; i++) {
 		PCB *p = processes[i];
 		if (p) {
 			free_process_resources(p);
 			processes[i] = NULL;
 		}
 	}
+	memset(pid_bitmap, 0, sizeof(pid_bitmap));
+	pid_hint = 0;
 }
 
 void scheduler_destroy(void)
@@ -593,18 +1333,16 @@ void scheduler_destroy(void)
 		return;
 	}
 
-	// Limpiar todas las colas de prioridades liberando nodos
-	for (int i = MAX_PRIORITY; i <= MIN_PRIORITY; i++) {
-		q_destroy(ready_queue[i]);
-		ready_queue[i] = NULL;
-	}
+	// Vaciar las colas READY (los enlaces viven en los PCBs)
+	rq_init();
+	dl_init();
+	bw_init();
 
 	cleanup_all_processes();
 
 	process_count         = 0;
 	total_cpu_ticks       = 0;
-	force_reschedule      = false;
-	current_pid           = NO_PID;
+	this_cpu()->current   = NULL;
 	scheduler_initialized = false;
 }
 
@@ -618,6 +1356,32 @@ PCB *scheduler_get_process(pid_t pid)
 	return processes[pid];
 }
 
+static void fill_process_info(process_info_t *info, PCB *p)
+{
+	info->pid = p->pid;
+	strncpy(info->name, p->name, MAX_PROCESS_NAME_LENGTH);
+	info->status               = p->status;
+	info->priority             = p->priority;
+	info->parent_pid           = p->parent_pid;
+	info->read_fd              = p->read_fd;
+	info->write_fd             = p->write_fd;
+	info->stack_base           = (uint64_t)p->stack_base;
+	info->stack_pointer        = (uint64_t)p->stack_pointer;
+	info->voluntary_switches   = p->voluntary_switches;
+	info->involuntary_switches = p->involuntary_switches;
+	info->cpu_ticks            = p->cpu_ticks;
+	info->wakeups              = p->wakeups;
+	info->wait_total_ns        = p->wait_total_ns;
+	info->wait_max_ns          = p->wait_max_ns;
+	memcpy(info->wait_hist, p->wait_hist, sizeof(p->wait_hist));
+	info->cpu              = (p->running_on != NO_CPU) ? p->running_on : p->cpu;
+	info->deadline         = dl_is_member(p);
+	info->batch            = p->batch;
+	info->owner_pid        = p->owner->pid;
+	info->group            = p->group;
+	info->missed_deadlines = p->dl_missed;
+}
+
 int scheduler_get_processes(process_info_t *buffer, int max_count)
 {
 	if (!scheduler_initialized || buffer == NULL || max_count <= 0) {
@@ -625,40 +1389,55 @@ int scheduler_get_processes(process_info_t *buffer, int max_count)
 	}
 
 	int count = 0;
-	for (int i = 0; i < MAX_PROCESSES && count < max_count; i++) {
-		PCB *p = processes[i];
-		if (p) {
-			buffer[count].pid = p->pid;
-			strncpy(buffer[count].name, p->name, MAX_PROCESS_NAME_LENGTH);
-			buffer[count].status        = p->status;
-			buffer[count].priority      = p->priority;
-			buffer[count].parent_pid    = p->parent_pid;
-			buffer[count].read_fd       = p->read_fd;
-			buffer[count].write_fd      = p->write_fd;
-			buffer[count].stack_base    = (uint64_t)p->stack_base;
-			buffer[count].stack_pointer = (uint64_t)p->stack_pointer;
-
-			count++;
+	for (uint32_t i = 0; i < table_size && count < max_count; i++) {
+		if (processes[i] != NULL) {
+			fill_process_info(&buffer[count++], processes[i]);
 		}
 	}
 
 	return count;
 }
 
+int scheduler_get_process_info(pid_t pid, process_info_t *info)
+{
+	PCB *p = scheduler_get_process(pid);
+	if (p == NULL || info == NULL) {
+		return -1;
+	}
+
+	fill_process_info(info, p);
+	return 0;
+}
+
+int scheduler_get_process_count(void)
+{
+	return scheduler_initialized ? (int)process_count : -1;
+}
+
 void scheduler_exit_process(int64_t ret_value)
 {
 	if (!scheduler_initialized) {
 		return;
 	}
 
-	PCB *current_process = processes[current_pid];
+	PCB *current_process = this_cpu()->current;
 
 	reparent_children_to_init(current_process->pid);
 
-	if (current_pid == foreground_process_pid) {
+	if (current_process->pid == foreground_process_pid) {
 		foreground_process_pid = SHELL_PID;
 	}
 	remove_process_from_all_semaphore_queues(current_process->pid);
+	dl_detach(current_process);
+	bw_detach(current_process);
+	kill_threads(current_process);
+
+	if (proc_is_thread(current_process)) {
+		// Queda para el join; sus fds son los del proceso
+		finish_thread(current_process, ret_value);
+		scheduler_yield();
+		return;
+	}
 
 	// limpia los fds abiertos
 	close_open_fds(current_process);
@@ -671,20 +1450,14 @@ void scheduler_exit_process(int64_t ret_value)
 		 // wait
 		// Lo sacamos de la cola de procesos ready para que no vuelva a correr PERO NO  del
 		// array de procesos (para que el padre pueda acceder a su ret_value)
-		if (current_process->status == PS_READY || current_process->status == PS_RUNNING) {
-			q_remove(ready_queue[current_process->effective_priority],
-			         current_process->pid);
-		}
+		rq_remove(current_process);
 		current_process->status =
 		        PS_TERMINATED; // Le cambio el estado despues de hacer el dequeue o sino no
 		                       // va a entrar en la condición del if
 		current_process->return_value = ret_value;
-		PCB *parent                   = processes[current_process->parent_pid];
 
-		// Si el padre estaba bloqueado haciendo waitpid, lo desbloqueamos
-		if (parent->status == PS_BLOCKED && parent->waiting_on == current_process->pid) {
-			scheduler_unblock_process(parent->pid);
-		}
+		// Queda para el wait del padre (si lo estaba esperando, lo desbloqueamos)
+		notify_parent(current_process);
 	}
 	scheduler_yield();
 }
@@ -693,26 +1466,59 @@ void scheduler_exit_process(int64_t ret_value)
 // terminó o 0.
 int scheduler_waitpid(pid_t child_pid)
 {
-	if (!scheduler_initialized || !pid_is_valid(child_pid) || processes[child_pid] == NULL ||
-	    processes[child_pid]->parent_pid != current_pid) {
+	if (!scheduler_initialized || !pid_is_valid(child_pid) || processes[child_pid] == NULL) {
 		return -1;
 	}
 
+	PCB *current = this_cpu()->current;
+	PCB *child   = processes[child_pid];
+	if (child->parent_pid != current->pid || proc_is_thread(child)) {
+		return -1; // a un hilo se le hace join
+	}
+
 	// Si el proceso hijo no termino, bloqueamos el proceso actual hasta que termine
 	if (processes[child_pid]->status != PS_TERMINATED) {
-		processes[current_pid]->waiting_on = child_pid;
-		scheduler_block_process(current_pid);
+		current->waiting_on = child_pid;
+		scheduler_block_process(current->pid);
 	}
 
 	// Llega acá cuando el hijo terminó y lo desbloqueo o si el hijo ya había terminado
 
-	processes[current_pid]->waiting_on = NO_PID;
-	int ret_value                      = processes[child_pid]->return_value;
+	current->waiting_on = NO_PID;
+	int ret_value       = processes[child_pid]->return_value;
 	scheduler_remove_process(child_pid);
 
 	return ret_value;
 }
 
+// Bloquea al proceso actual hasta que termine cualquiera de sus hijos. Devuelve el PID del hijo
+// (y su valor de retorno en status, si no es NULL) o -1 si no tiene hijos.
+int scheduler_waitany(int *status)
+{
+	if (!scheduler_initialized) {
+		return -1;
+	}
+
+	PCB *current = this_cpu()->current;
+	while (current->zombies == NULL) {
+		if (current->children == NULL) {
+			return -1;
+		}
+		current->waiting_on = ANY_CHILD;
+		scheduler_block_process(current->pid);
+	}
+	current->waiting_on = NO_PID;
+
+	PCB  *child = current->zombies;
+	pid_t pid   = child->pid;
+	if (status != NULL) {
+		*status = child->return_value;
+	}
+	scheduler_remove_process(pid);
+
+	return pid;
+}
+
 int adopt_init_as_parent(pid_t pid)
 {
 	if (!scheduler_initialized || !pid_is_valid(pid)) {
@@ -724,29 +1530,37 @@ int adopt_init_as_parent(pid_t pid)
 	}
 
 	PCB *orphan_process = processes[pid];
-	if (orphan_process == NULL) {
+	if (orphan_process == NULL || proc_is_thread(orphan_process)) {
 		return -1;
 	}
 
+	if (orphan_process->status == PS_TERMINATED) {
+		// Ya terminó: init no hace wait, así que se lo remueve directamente
+		return scheduler_remove_process(pid);
+	}
+
+	unlink_child(orphan_process);
 	orphan_process->parent_pid = INIT_PID;
+	link_child(orphan_process);
 	return 0;
 }
 
+// Recorre solo los hijos del proceso: los terminados se remueven y los demás pasan a ser de init
 static void reparent_children_to_init(pid_t pid)
 {
-	if (!scheduler_initialized || !pid_is_valid(pid)) {
+	if (!scheduler_initialized || !pid_is_valid(pid) || processes[pid] == NULL) {
 		return;
 	}
-	for (int i = 0; i < MAX_PROCESSES; i++) {
-		if (processes[i] != NULL && processes[i]->parent_pid == pid) {
-			// Asignar el proceso huérfano al init
-			if (processes[i]->status == PS_TERMINATED) {
-				// Si el hijo ya estaba terminado, lo removemos directamente
-				scheduler_remove_process(processes[i]->pid);
-			} else {
-				processes[i]->parent_pid = INIT_PID;
-			}
-		}
+	PCB *parent = processes[pid];
+
+	while (parent->zombies != NULL) {
+		scheduler_remove_process(parent->zombies->pid);
+	}
+	while (parent->children != NULL) {
+		PCB *orphan = parent->children;
+		unlink_child(orphan);
+		orphan->parent_pid = INIT_PID;
+		link_child(orphan);
 	}
 }
 
@@ -768,3 +1582,64 @@ int scheduler_kill_foreground_process(void)
 
 	return result;
 }
+
+// Pasa al proceso actual a la clase de tiempo real (o lo saca, con runtime == 0). Si la CPU que lo
+// admitió es otra, deja esta y sigue corriendo allá.
+int scheduler_set_deadline(uint32_t runtime, uint32_t period, uint32_t deadline)
+{
+	if (!scheduler_initialized) {
+		return -1;
+	}
+
+	PCB *current = this_cpu()->current;
+	if (current == NULL || !current->killable) {
+		return -1; // init y la shell no pueden acaparar la CPU
+	}
+
+	int cpu = dl_set_params(current, runtime, period, deadline, ticks_elapsed());
+	if (cpu == NO_CPU) {
+		return -1;
+	}
+
+	if (cpu != this_cpu()->id) {
+		smp_send_resched(cpu);
+	}
+	scheduler_force_reschedule();
+	return 0;
+}
+
+int scheduler_set_quantum(uint8_t priority, uint32_t ticks)
+{
+	if (!scheduler_initialized || priority < MAX_PRIORITY || priority > MIN_PRIORITY ||
+	    ticks < 1 || ticks > MAX_QUANTUM) {
+		return -1;
+	}
+
+	return rq_set_quantum(priority, ticks);
+}
+
+int scheduler_get_quantum(uint8_t priority)
+{
+	if (!scheduler_initialized || priority < MAX_PRIORITY || priority > MIN_PRIORITY) {
+		return -1;
+	}
+	return rq_get_quantum(priority);
+}
+
+int scheduler_get_stats(sched_stats_t *buffer)
+{
+	if (!scheduler_initialized || buffer == NULL) {
+		return -1;
+	}
+
+	*buffer              = sched_stats;
+	buffer->cpu_count    = smp_cpu_count();
+	buffer->ready_count  = 0;
+	buffer->idle_wakeups = 0;
+	buffer->fpu_traps    = fpu_trap_count();
+	for (int i = 0; i < smp_cpu_count(); i++) {
+		buffer->ready_count += rq_count(i);
+		buffer->idle_wakeups += smp_get_cpu(i)->idle_wakeups;
+	}
+	return 0;
+}
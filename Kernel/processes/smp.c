@@ -0,0 +1,205 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "smp.h"
+#include "apic.h"
+#include "lib.h"
+#include "memory_manager.h"
+#include "synchro.h"
+#include "time.h"
+#include "fpu.h"
+
+#define IA32_GS_BASE 0xC0000101
+
+// Datos que deja Pure64 en el InfoMap
+#define INFOMAP_CPU_DETECTED ((volatile uint16_t *)0x5014)
+#define INFOMAP_APIC_IDS ((volatile uint8_t *)0x5100) // APIC ID de cada core detectado
+#define INFOMAP_AP_READY ((volatile uint8_t *)0x5700) // 1 en [apic_id] si el AP llegó a 64 bits
+
+#define SCHED_HZ 100             // misma frecuencia que el PIT del BSP
+#define AP_START_TIMEOUT_TICKS 10 // 100 ms para que un AP avise que está online
+
+extern void write_msr(uint32_t msr, uint64_t value);
+extern void cpu_relax(void);
+extern void _cli(void);
+
+static cpu_t    cpus[MAX_CPUS];
+static int      cpu_count         = 1;
+static lock_t   kernel_big_lock   = 1; // 1 = libre (convención de synchro.asm)
+static uint32_t lapic_timer_count = 0; // cuenta inicial del timer del LAPIC para SCHED_HZ
+
+static void set_cpu_local(cpu_t *cpu)
+{
+	cpu->self = cpu;
+	write_msr(IA32_GS_BASE, (uint64_t)cpu);
+}
+
+// Busca la entrada que el BSP preparó para el AP que está arrancando
+static cpu_t *find_starting_cpu(void)
+{
+	uint8_t apic_id = lapic_id();
+	for (int i = BSP_CPU + 1; i < MAX_CPUS; i++) {
+		if (cpus[i].stack_base != NULL && !cpus[i].online && cpus[i].apic_id == apic_id) {
+			return &cpus[i];
+		}
+	}
+	return NULL;
+}
+
+void smp_init(void)
+{
+	cpu_t *bsp  = &cpus[BSP_CPU];
+	bsp->id     = BSP_CPU;
+	bsp->online = true;
+	if (lapic_init()) {
+		bsp->apic_id = lapic_id();
+	}
+	set_cpu_local(bsp);
+}
+
+void smp_start_aps(void)
+{
+	if (!lapic_present()) {
+		return;
+	}
+
+	lapic_timer_count = lapic_timer_calibrate(SCHED_HZ);
+
+	memory_manager_ADT mm       = get_kernel_memory_manager();
+	uint16_t           detected = *INFOMAP_CPU_DETECTED;
+
+	for (int i = 0; i < detected && cpu_count < MAX_CPUS; i++) {
+		uint8_t apic_id = INFOMAP_APIC_IDS[i];
+		if (apic_id == cpus[BSP_CPU].apic_id || INFOMAP_AP_READY[apic_id] != 1) {
+			continue;
+		}
+
+		cpu_t *cpu      = &cpus[cpu_count];
+		cpu->stack_base = alloc_memory(mm, AP_STACK_SIZE);
+		if (cpu->stack_base == NULL) {
+			break;
+		}
+		cpu->id      = cpu_count;
+		cpu->apic_id = apic_id;
+
+		// El AP está en el loop de halt de Pure64 con interrupciones habilitadas y comparte
+		// la IDT del kernel: la IPI lo hace saltar a smp_ap_main
+		lapic_send_ipi(apic_id, AP_START_VECTOR);
+
+		uint64_t start = ticks_elapsed();
+		while (!cpu->online && ticks_elapsed() - start < AP_START_TIMEOUT_TICKS) {
+			cpu_relax();
+		}
+
+		if (cpu->online) {
+			cpu_count++;
+		} else {
+			free_memory(mm, cpu->stack_base);
+			memset(cpu, 0, sizeof(cpu_t));
+		}
+	}
+}
+
+void *smp_ap_stack_top(void)
+{
+	cpu_t *cpu = find_starting_cpu();
+	if (cpu == NULL) {
+		return NULL;
+	}
+	return (char *)cpu->stack_base + AP_STACK_SIZE;
+}
+
+void smp_ap_main(void)
+{
+	cpu_t *cpu = find_starting_cpu();
+	set_cpu_local(cpu);
+	fpu_init_cpu();
+
+	// Confirmar la IPI de arranque: si no, el LAPIC no entrega interrupciones de igual o menor
+	// prioridad (el timer)
+	lapic_eoi();
+
+	cpu->in_idle = true;
+	lapic_timer_start(lapic_timer_count, LAPIC_TIMER_VECTOR);
+	cpu->online = true;
+
+	// Contexto idle del AP: el scheduler vuelve acá cuando no hay procesos para esta CPU
+	while (1) {
+		_hlt();
+	}
+}
+
+int smp_cpu_count(void)
+{
+	return cpu_count;
+}
+
+uint32_t smp_timer_count(void)
+{
+	return lapic_timer_count;
+}
+
+cpu_t *smp_get_cpu(int id)
+{
+	if (id < 0 || id >= cpu_count) {
+		return NULL;
+	}
+	return &cpus[id];
+}
+
+void smp_send_resched(int cpu_id)
+{
+	if (cpu_id < 0 || cpu_id >= cpu_count || cpu_id == this_cpu()->id) {
+		return;
+	}
+	lapic_send_ipi(cpus[cpu_id].apic_id, RESCHED_VECTOR);
+}
+
+void kernel_lock(void)
+{
+	cpu_t *cpu = this_cpu();
+	if (cpu->lock_depth == 0) {
+		acquire_lock(&kernel_big_lock);
+	}
+	cpu->lock_depth++;
+}
+
+void kernel_unlock(void)
+{
+	cpu_t *cpu = this_cpu();
+	if (--cpu->lock_depth == 0) {
+		release_lock(&kernel_big_lock);
+	}
+}
+
+uint32_t kernel_unlock_all(void)
+{
+	cpu_t   *cpu   = this_cpu();
+	uint32_t depth = cpu->lock_depth;
+
+	if (depth > 0) {
+		cpu->lock_depth = 0;
+		release_lock(&kernel_big_lock);
+	}
+	return depth;
+}
+
+void kernel_relock(uint32_t depth)
+{
+	// Si el proceso fue desalojado mientras no tenía el lock, puede estar en otra CPU
+	if (depth > 0) {
+		acquire_lock(&kernel_big_lock);
+		this_cpu()->lock_depth = depth;
+	}
+}
+
+void kernel_wait_for_interrupt(void)
+{
+	uint32_t depth = kernel_unlock_all();
+
+	// Mientras está en halt el proceso puede ser desalojado y seguir en otra CPU
+	_hlt();
+	_cli();
+
+	kernel_relock(depth);
+}
@@ -4,26 +4,34 @@
 #include "synchro.h"
 #include "scheduler.h"
 #include "memory_manager.h"
+#include "slab.h"
 #include "lib.h"
 #include "process.h"
 #include "video_driver.h"
 
+// Un mutex (creado con mutex_open) es un semáforo que arranca en 1 y sigue a su dueño (holder)
+// para que herede la prioridad del más prioritario de los que lo esperan y no lo posterguen
+// procesos de prioridad media. Los semáforos de sem_open no siguen dueño, aunque arranquen en 1.
+#define MUTEX_INITIAL_VALUE 1
+#define MAX_PI_CHAIN 8 // dueños que se recorren cuando el dueño a su vez espera otro mutex
+
+// Cola FIFO de procesos bloqueados, enlazada por los PCBs (sem_next): no depende de la cantidad
+// máxima de procesos
 typedef struct {
-	uint32_t pids[MAX_PROCESSES]; // Array de PIDs circular
-	uint32_t read_index;  // Índice de lectura (frente de la cola) (donde sacas el próximo
-	                      // elemento)
-	uint32_t write_index; // Índice de escritura (final de la cola) (donde pones el próximo
-	                      // elemento)
-	uint32_t size;        // Cantidad de elementos en la cola
-} circular_buffer_t;
+	PCB     *head; // próximo en despertarse
+	PCB     *tail;
+	uint32_t size; // Cantidad de elementos en la cola
+} wait_queue_t;
 
 typedef struct {
-	int               value; // Contador del semáforo
-	uint32_t          owner_pids[MAX_PROCESSES];
-	int               ref_count; // Cantidad de procesos usando este semáforo
-	char              name[MAX_SEM_NAME_LENGTH];
-	circular_buffer_t queue;
-	int               lock; // Spinlock simple para proteger acceso concurrente
+	int          value;                        // Contador del semáforo
+	uint64_t     owner_pids[PID_BITMAP_WORDS]; // bitmap de los PIDs que lo abrieron
+	int          ref_count;                    // Cantidad de procesos usando este semáforo
+	char         name[MAX_SEM_NAME_LENGTH];
+	wait_queue_t queue;
+	int          lock;   // Spinlock simple para proteger acceso concurrente
+	bool         mutex;  // creado con mutex_open: hay herencia de prioridad
+	int          holder; // PID del dueño del mutex (NO_PID si está libre o no es mutex)
 } semaphore_t;
 
 typedef struct {
@@ -32,6 +40,7 @@ typedef struct {
 } semaphore_manager_t;
 
 static semaphore_manager_t *sem_manager = NULL;
+static slab_cache_t         sem_cache   = SLAB_CACHE("semaphore", semaphore_t, NULL);
 
 static int64_t      get_free_id(void);
 static uint64_t     pop_from_queue(semaphore_t *sem);
@@ -40,12 +49,43 @@ static semaphore_t *get_sem_by_name(const char *name);
 static int          get_idx_by_name(const char *name);
 static int          remove_process_from_queue(semaphore_t *sem, uint32_t pid);
 static int64_t      sem_close_by_pid(char *name, uint32_t pid);
-static void
-init_semaphore_struct(semaphore_t *sem, const char *name, int initial_value, uint32_t owner_pid);
+static int64_t      open_semaphore(char *name, int initial_value, bool mutex);
+static void         init_semaphore_struct(semaphore_t *sem, const char *name, int initial_value,
+                                          bool mutex, uint32_t owner_pid);
+static void inherit_priority(semaphore_t *sem, uint8_t priority);
+static void update_inherited_priority(int pid);
+
+// Prioridad con la que corre el proceso contando la que heredó
+static uint8_t priority_of(PCB *p)
+{
+	return p->pi_priority < p->priority ? p->pi_priority : p->priority;
+}
+
+// Los procesos que quedaban bloqueados dejan de apuntar al semáforo que se destruye
+static void detach_waiters(semaphore_t *sem)
+{
+	while (sem->queue.head != NULL) {
+		pop_from_queue(sem);
+	}
+
+	// El dueño deja de heredar la prioridad de los que lo esperaban
+	int holder  = sem->holder;
+	sem->holder = NO_PID;
+	update_inherited_priority(holder);
+}
 
 static int pid_present_in_semaphore(semaphore_t *sem, uint32_t pid)
 {
-	return sem->owner_pids[pid];
+	return (sem->owner_pids[pid / 64] >> (pid % 64)) & 1;
+}
+
+static void set_owner(semaphore_t *sem, uint32_t pid, int state)
+{
+	if (state == OCCUPIED) {
+		sem->owner_pids[pid / 64] |= 1ull << (pid % 64);
+	} else {
+		sem->owner_pids[pid / 64] &= ~(1ull << (pid % 64));
+	}
 }
 
 void init_semaphore_manager(void)
@@ -69,6 +109,17 @@ void init_semaphore_manager(void)
 }
 
 int64_t sem_open(char *name, int initial_value)
+{
+	return open_semaphore(name, initial_value, false);
+}
+
+int64_t mutex_open(char *name)
+{
+	return open_semaphore(name, MUTEX_INITIAL_VALUE, true);
+}
+
+// Si ya existe, el modo y el valor son los de quien lo creó
+static int64_t open_semaphore(char *name, int initial_value, bool mutex)
 {
 	if (sem_manager == NULL || name == NULL) {
 		return -1;
@@ -82,7 +133,7 @@ int64_t sem_open(char *name, int initial_value)
 			return ERROR; // El proceso ya posee este semáforo
 		}
 		acquire_lock(&sem->lock);
-		sem->owner_pids[scheduler_get_current_pid()] = 1;
+		set_owner(sem, scheduler_get_current_pid(), OCCUPIED);
 		sem->ref_count++;
 		release_lock(&sem->lock);
 		return OK;
@@ -95,13 +146,12 @@ int64_t sem_open(char *name, int initial_value)
 	}
 
 	// Crear nuevo semáforo
-	memory_manager_ADT mm = get_kernel_memory_manager();
-	sem                   = alloc_memory(mm, sizeof(semaphore_t));
+	sem = slab_alloc(&sem_cache);
 	if (sem == NULL) {
 		return ERROR;
 	}
 
-	init_semaphore_struct(sem, name, initial_value, scheduler_get_current_pid());
+	init_semaphore_struct(sem, name, initial_value, mutex, scheduler_get_current_pid());
 
 	sem_manager->semaphores[id] = sem;
 	sem_manager->semaphore_count++;
@@ -126,7 +176,7 @@ int64_t sem_close(char *name)
 
 	if (sem->ref_count > 1) {
 		sem->ref_count--;
-		sem->owner_pids[scheduler_get_current_pid()] = FREE;
+		set_owner(sem, scheduler_get_current_pid(), FREE);
 		release_lock(&sem->lock);
 		return OK;
 	}
@@ -134,8 +184,8 @@ int64_t sem_close(char *name)
 	release_lock(&sem->lock);
 
 	// Último proceso usando el semáforo, destruirlo
-	memory_manager_ADT mm = get_kernel_memory_manager();
-	free_memory(mm, sem);
+	detach_waiters(sem);
+	slab_free(&sem_cache, sem);
 	sem_manager->semaphores[idx] = NULL;
 	sem_manager->semaphore_count--;
 
@@ -155,20 +205,28 @@ int64_t sem_wait(char *name)
 
 	acquire_lock(&sem->lock);
 
+	int pid = scheduler_get_current_pid();
+
 	if (sem->value > 0) {
 		sem->value--;
+		if (sem->mutex) {
+			sem->holder = pid;
+		}
 		release_lock(&sem->lock);
 		return OK;
 	}
 
 	// No hay recursos disponibles, bloquear proceso
-	int pid = scheduler_get_current_pid();
-
 	if (add_to_queue(sem, pid) == ERROR) {
 		release_lock(&sem->lock);
 		return ERROR;
 	}
 
+	// El dueño del mutex corre al menos con la prioridad del que lo espera
+	if (sem->mutex) {
+		inherit_priority(sem, priority_of(scheduler_get_process(pid)));
+	}
+
 	_cli();
 
 	release_lock(&sem->lock);
@@ -193,17 +251,29 @@ int64_t sem_post(char *name)
 
 	acquire_lock(&sem->lock);
 
+	int releaser = sem->holder;
+
 	if (sem->queue.size > 0) {
 		// Hay procesos esperando, desbloquear uno
 		uint32_t pid = pop_from_queue(sem);
+		if (sem->mutex) {
+			sem->holder = pid; // el mutex pasa directamente al que se despierta
+		}
 		_cli(); // deshabilitar interrupciones
 		release_lock(&sem->lock);
+		if (sem->mutex) {
+			// Quien lo soltó vuelve a su prioridad y el nuevo dueño hereda la de los que siguen
+			update_inherited_priority(releaser);
+			update_inherited_priority(pid);
+		}
 		scheduler_unblock_process(pid);
 		_sti(); // habilitar interrupciones
 	} else {
 		// No hay procesos esperando, incrementar contador
 		sem->value++;
+		sem->holder = NO_PID;
 		release_lock(&sem->lock);
+		update_inherited_priority(releaser);
 	}
 
 	return OK;
@@ -215,18 +285,28 @@ int remove_process_from_all_semaphore_queues(uint32_t pid)
 		return ERROR;
 	}
 
+	// Si está bloqueado en un semáforo, el PCB dice en cuál
+	PCB *p = scheduler_get_process(pid);
+	if (p != NULL && p->sem_waiting != NULL) {
+		semaphore_t *sem = p->sem_waiting;
+		acquire_lock(&sem->lock);
+		remove_process_from_queue(sem, pid);
+		release_lock(&sem->lock);
+		update_inherited_priority(sem->holder);
+	}
+
 	for (int i = 0; i < MAX_SEMAPHORES; i++) {
 		semaphore_t *sem = sem_manager->semaphores[i];
 		if (sem == NULL) {
 			continue;
 		}
 
-		if (sem->owner_pids[pid] == OCCUPIED) {
-			if (scheduler_get_process(pid)->status == PS_BLOCKED) {
-				acquire_lock(&sem->lock);
-				remove_process_from_queue(sem, pid);
-				release_lock(&sem->lock);
-			}
+		// Un mutex cuyo dueño termina queda sin dueño (su PID se puede reusar)
+		if (sem->holder == (int)pid) {
+			sem->holder = NO_PID;
+		}
+
+		if (pid_present_in_semaphore(sem, pid)) {
 			sem_close_by_pid(sem->name, pid);
 		}
 	}
@@ -234,21 +314,21 @@ int remove_process_from_all_semaphore_queues(uint32_t pid)
 	return OK;
 }
 
-static void
-init_semaphore_struct(semaphore_t *sem, const char *name, int initial_value, uint32_t owner_pid)
+static void init_semaphore_struct(semaphore_t *sem, const char *name, int initial_value,
+                                  bool mutex, uint32_t owner_pid)
 {
 	sem->value = initial_value;
 	strncpy(sem->name, name, MAX_SEM_NAME_LENGTH - 1);
 	sem->name[MAX_SEM_NAME_LENGTH - 1] = '\0';
-	sem->queue.read_index              = 0;
-	sem->queue.write_index             = 0;
+	sem->queue.head                    = NULL;
+	sem->queue.tail                    = NULL;
 	sem->queue.size                    = 0;
 	sem->lock                          = 1; // Spinlock desbloqueado
 	sem->ref_count                     = 1;
-	for (int i = 0; i < MAX_PROCESSES; i++) {
-		sem->owner_pids[i] = FREE;
-	}
-	sem->owner_pids[owner_pid] = OCCUPIED;
+	sem->mutex                         = mutex;
+	sem->holder                        = NO_PID;
+	memset(sem->owner_pids, 0, sizeof(sem->owner_pids));
+	set_owner(sem, owner_pid, OCCUPIED);
 }
 
 static int64_t get_free_id(void)
@@ -263,25 +343,37 @@ static int64_t get_free_id(void)
 
 static uint64_t pop_from_queue(semaphore_t *sem)
 {
-	if (sem->queue.size == 0) {
+	PCB *p = sem->queue.head;
+	if (p == NULL) {
 		return ERROR;
 	}
 
-	uint32_t pid          = sem->queue.pids[sem->queue.read_index];
-	sem->queue.read_index = (sem->queue.read_index + 1) % MAX_PROCESSES;
+	sem->queue.head = p->sem_next;
+	if (sem->queue.head == NULL) {
+		sem->queue.tail = NULL;
+	}
 	sem->queue.size--;
+	p->sem_next    = NULL;
+	p->sem_waiting = NULL;
 
-	return pid;
+	return p->pid;
 }
 
 static int add_to_queue(semaphore_t *sem, uint32_t pid)
 {
-	if (sem->queue.size >= MAX_PROCESSES) {
+	PCB *p = scheduler_get_process(pid);
+	if (p == NULL || p->sem_waiting != NULL) {
 		return ERROR;
 	}
 
-	sem->queue.pids[sem->queue.write_index] = pid;
-	sem->queue.write_index                  = (sem->queue.write_index + 1) % MAX_PROCESSES;
+	p->sem_next    = NULL;
+	p->sem_waiting = sem;
+	if (sem->queue.tail != NULL) {
+		sem->queue.tail->sem_next = p;
+	} else {
+		sem->queue.head = p;
+	}
+	sem->queue.tail = p;
 	sem->queue.size++;
 
 	return OK;
@@ -309,38 +401,30 @@ static semaphore_t *get_sem_by_name(const char *name)
 
 static int remove_process_from_queue(semaphore_t *sem, uint32_t pid)
 {
-	if (sem->queue.size == 0) {
-		return ERROR;
-	}
-
-	uint32_t i     = sem->queue.read_index;
-	uint32_t j     = 0;
-	int      found = ERROR;
+	PCB *prev = NULL;
+	PCB *p    = sem->queue.head;
 
 	// Buscar el proceso en la cola
-	while (j < sem->queue.size) {
-		if (sem->queue.pids[i] == pid) {
-			found = i;
-			break;
-		}
-		i = (i + 1) % MAX_PROCESSES;
-		j++;
+	while (p != NULL && p->pid != (int)pid) {
+		prev = p;
+		p    = p->sem_next;
 	}
 
-	if (found == ERROR) {
+	if (p == NULL) {
 		return ERROR; // No encontrado
 	}
 
-	// Desplazar elementos para llenar el hueco
-	for (uint32_t k = found; k != sem->queue.write_index; k = (k + 1) % MAX_PROCESSES) {
-		uint32_t next      = (k + 1) % MAX_PROCESSES;
-		sem->queue.pids[k] = sem->queue.pids[next];
+	if (prev != NULL) {
+		prev->sem_next = p->sem_next;
+	} else {
+		sem->queue.head = p->sem_next;
+	}
+	if (sem->queue.tail == p) {
+		sem->queue.tail = prev;
 	}
-
-	// Es un truco matemático para evitar números negativos al retroceder en aritmética
-	// circular.
-	sem->queue.write_index = (sem->queue.write_index + MAX_PROCESSES - 1) % MAX_PROCESSES;
 	sem->queue.size--;
+	p->sem_next    = NULL;
+	p->sem_waiting = NULL;
 
 	return OK;
 }
@@ -362,7 +446,7 @@ static int64_t sem_close_by_pid(char *name, uint32_t pid)
 
 	if (sem->ref_count > 1) {
 		sem->ref_count--;
-		sem->owner_pids[pid] = FREE;
+		set_owner(sem, pid, FREE);
 		release_lock(&sem->lock);
 		return OK;
 	}
@@ -370,10 +454,48 @@ static int64_t sem_close_by_pid(char *name, uint32_t pid)
 	release_lock(&sem->lock);
 
 	// Ultimo proceso usando el semaforo, destruirlo
-	memory_manager_ADT mm = get_kernel_memory_manager();
-	free_memory(mm, sem);
+	detach_waiters(sem);
+	slab_free(&sem_cache, sem);
 	sem_manager->semaphores[idx] = NULL;
 	sem_manager->semaphore_count--;
 
 	return OK;
-}
\ No newline at end of file
+}
+
+// Sube la prioridad heredada del dueño del mutex, y si ese dueño está bloqueado esperando otro
+// mutex, la del dueño de ese también (hasta MAX_PI_CHAIN dueños)
+static void inherit_priority(semaphore_t *sem, uint8_t priority)
+{
+	for (int i = 0; i < MAX_PI_CHAIN && sem != NULL && sem->mutex; i++) {
+		PCB *holder = scheduler_get_process(sem->holder);
+		if (holder == NULL || holder->pi_priority <= priority) {
+			return;
+		}
+		scheduler_set_inherited_priority(holder->pid, priority);
+		sem = holder->sem_waiting;
+	}
+}
+
+// Recalcula la prioridad que hereda el proceso: la del más prioritario de los que esperan algún
+// mutex suyo, o ninguna (MIN_PRIORITY)
+static void update_inherited_priority(int pid)
+{
+	if (pid == NO_PID) {
+		return;
+	}
+
+	uint8_t priority = MIN_PRIORITY;
+	for (int i = 0; i < MAX_SEMAPHORES; i++) {
+		semaphore_t *sem = sem_manager->semaphores[i];
+		if (sem == NULL || sem->holder != pid) {
+			continue;
+		}
+		for (PCB *w = sem->queue.head; w != NULL; w = w->sem_next) {
+			if (priority_of(w) < priority) {
+				priority = priority_of(w);
+			}
+		}
+	}
+
+	scheduler_set_inherited_priority(pid, priority);
+}
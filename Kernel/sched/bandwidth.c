@@ -0,0 +1,170 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Cuotas de CPU por grupo de procesos. Se compila siempre, sobre cualquiera de las dos políticas:
+// la política no sabe de grupos, el scheduler estaciona fuera de sus colas a los procesos que elige
+// de un grupo sin cuota y los vuelve a encolar cuando empieza el período siguiente.
+#include "bandwidth.h"
+#include "scheduler.h"
+#include "smp.h"
+#include <stddef.h>
+
+typedef struct group {
+	uint32_t quota;        // ticks por período (0: sin límite)
+	uint32_t period;       // ticks
+	uint32_t used;         // ticks usados en el período actual
+	uint64_t period_start; // tick en el que empezó el período actual
+	uint64_t total_ticks;
+	uint64_t throttles;
+	PCB     *parked; // procesos READY esperando el próximo período (lista por bw_next/bw_prev)
+} group_t;
+
+// Todo el estado se modifica con el lock del kernel tomado
+static group_t  groups[MAX_GROUPS];
+static uint32_t limited_groups; // grupos con cuota: sin ninguno bw_tick no recorre nada
+static uint32_t parked_count;
+
+void bw_init(void)
+{
+	for (int i = 0; i < MAX_GROUPS; i++) {
+		groups[i].quota        = 0;
+		groups[i].period       = 0;
+		groups[i].used         = 0;
+		groups[i].period_start = 0;
+		groups[i].total_ticks  = 0;
+		groups[i].throttles    = 0;
+		groups[i].parked       = NULL;
+	}
+	limited_groups = 0;
+	parked_count   = 0;
+}
+
+static void unlink_parked(PCB *p)
+{
+	group_t *g = &groups[p->group];
+	if (p->bw_prev != NULL) {
+		p->bw_prev->bw_next = p->bw_next;
+	} else {
+		g->parked = p->bw_next;
+	}
+	if (p->bw_next != NULL) {
+		p->bw_next->bw_prev = p->bw_prev;
+	}
+	p->bw_next   = NULL;
+	p->bw_prev   = NULL;
+	p->bw_parked = false;
+	parked_count--;
+}
+
+// Saca a todos los estacionados del grupo y los agrega a la lista released
+static PCB *release_parked(group_t *g, PCB *released)
+{
+	while (g->parked != NULL) {
+		PCB *p = g->parked;
+		unlink_parked(p);
+		p->bw_next = released;
+		released   = p;
+	}
+	return released;
+}
+
+int bw_set_quota(int group, uint32_t quota, uint32_t period, uint64_t now, PCB **released)
+{
+	*released = NULL;
+	if (!bw_valid_group(group) || group == ROOT_GROUP) {
+		return -1;
+	}
+	// Con varias CPUs un grupo puede usar más de un período de CPU por período
+	if (quota != 0 && (period == 0 || period > MAX_BW_PERIOD || quota > period * MAX_CPUS)) {
+		return -1;
+	}
+
+	group_t *g = &groups[group];
+	if (g->quota == 0 && quota != 0) {
+		limited_groups++;
+	} else if (g->quota != 0 && quota == 0) {
+		limited_groups--;
+	}
+
+	g->quota        = quota;
+	g->period       = quota != 0 ? period : 0;
+	g->used         = 0;
+	g->period_start = now;
+	*released       = release_parked(g, NULL);
+	return 0;
+}
+
+void bw_charge(PCB *p)
+{
+	group_t *g = &groups[p->group];
+	g->total_ticks++;
+	if (g->quota != 0 && ++g->used == g->quota) {
+		g->throttles++;
+	}
+}
+
+bool bw_throttled(PCB *p)
+{
+	group_t *g = &groups[p->group];
+	return g->quota != 0 && g->used >= g->quota;
+}
+
+void bw_park(PCB *p)
+{
+	group_t *g = &groups[p->group];
+	p->bw_prev = NULL;
+	p->bw_next = g->parked;
+	if (g->parked != NULL) {
+		g->parked->bw_prev = p;
+	}
+	g->parked    = p;
+	p->bw_parked = true;
+	parked_count++;
+}
+
+void bw_detach(PCB *p)
+{
+	if (p->bw_parked) {
+		unlink_parked(p);
+	}
+}
+
+bool bw_pending(void)
+{
+	return parked_count > 0;
+}
+
+PCB *bw_tick(uint64_t now)
+{
+	if (limited_groups == 0) {
+		return NULL;
+	}
+
+	PCB *released = NULL;
+	for (int i = 0; i < MAX_GROUPS; i++) {
+		group_t *g = &groups[i];
+		if (g->quota == 0 || now - g->period_start < g->period) {
+			continue;
+		}
+		// Los períodos quedan alineados aunque el tick se haya atrasado
+		g->period_start = now - (now - g->period_start) % g->period;
+		g->used         = 0;
+		released        = release_parked(g, released);
+	}
+	return released;
+}
+
+void bw_get_info(group_info_t info[MAX_GROUPS])
+{
+	for (int i = 0; i < MAX_GROUPS; i++) {
+		group_t *g          = &groups[i];
+		info[i].id          = i;
+		info[i].quota       = g->quota;
+		info[i].period      = g->period;
+		info[i].period_used = g->used;
+		info[i].total_ticks = g->total_ticks;
+		info[i].throttles   = g->throttles;
+		info[i].processes   = 0;
+		info[i].throttled   = g->quota != 0 && g->used >= g->quota;
+	}
+}
@@ -0,0 +1,334 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Scheduler fair-share al estilo CFS: cada proceso acumula runtime virtual (tiempo de CPU real
+// escalado por el inverso de su peso) y siempre corre el que menos acumuló. La prioridad de
+// sys_nice se traduce a un peso, así que un proceso de prioridad 0 recibe ~3 veces más CPU que
+// uno de prioridad 1, en vez de desplazarlo por completo. Los procesos batch no acumulan runtime
+// virtual: esperan en una cola FIFO aparte que solo se atiende cuando el heap está vacío.
+#include "runqueue.h"
+#include "scheduler.h"
+#include "smp.h"
+#include "time.h"
+#include "memory_manager.h"
+#include "lib.h"
+#include <stddef.h>
+
+#define NICE_0_WEIGHT 1024
+#define SCHED_LATENCY_TICKS 6          // período en el que corren una vez todos los listos
+#define WAKEUP_GRANULARITY_NS 10000000 // ventaja mínima para desalojar al que está corriendo
+#define SLEEPER_CREDIT_NS 5000000      // crédito de un proceso que vuelve de estar bloqueado
+
+// Cola en la que está encolado un proceso (rq_level)
+#define HEAP_QUEUE 0
+#define BATCH_QUEUE 1
+
+// Peso de cada prioridad (valores de la tabla de Linux para nice -5, 0 y +5)
+static const uint32_t priority_weight[PRIORITY_COUNT] = {3121, NICE_0_WEIGHT, 335};
+
+// Cola READY de cada CPU: min-heap de PCBs ordenado por vruntime (la posición de cada proceso
+// se guarda en rq_index para poder sacarlo del medio en O(log n)). Los arreglos salen del heap del
+// kernel y crecen con la tabla de procesos (rq_reserve).
+static PCB    **heap[MAX_CPUS];
+static uint32_t heap_capacity; // lugares en el arreglo de cada CPU
+static uint32_t heap_size[MAX_CPUS];
+static uint64_t queue_weight[MAX_CPUS]; // suma de los pesos encolados
+static uint64_t min_vruntime[MAX_CPUS]; // nunca decrece: referencia para ubicar a los que llegan
+
+// Cola batch de cada CPU, enlazada por rq_next/rq_prev
+static PCB     *batch_head[MAX_CPUS];
+static PCB     *batch_tail[MAX_CPUS];
+static uint32_t batch_count[MAX_CPUS];
+
+// Con prioridad heredada (pi_priority) usa el peso de esa prioridad si es mayor
+static inline uint32_t weight_of(PCB *p)
+{
+	return priority_weight[p->pi_priority < p->priority ? p->pi_priority : p->priority];
+}
+
+static void heap_swap(PCB **h, uint32_t i, uint32_t j)
+{
+	PCB *aux       = h[i];
+	h[i]           = h[j];
+	h[j]           = aux;
+	h[i]->rq_index = i;
+	h[j]->rq_index = j;
+}
+
+static void sift_up(PCB **h, uint32_t i)
+{
+	while (i > 0) {
+		uint32_t parent = (i - 1) / 2;
+		if (h[parent]->vruntime <= h[i]->vruntime) {
+			return;
+		}
+		heap_swap(h, i, parent);
+		i = parent;
+	}
+}
+
+static void sift_down(PCB **h, uint32_t size, uint32_t i)
+{
+	while (1) {
+		uint32_t smallest = i;
+		uint32_t left     = 2 * i + 1;
+		uint32_t right    = 2 * i + 2;
+		if (left < size && h[left]->vruntime < h[smallest]->vruntime) {
+			smallest = left;
+		}
+		if (right < size && h[right]->vruntime < h[smallest]->vruntime) {
+			smallest = right;
+		}
+		if (smallest == i) {
+			return;
+		}
+		heap_swap(h, i, smallest);
+		i = smallest;
+	}
+}
+
+static void update_min_vruntime(int cpu, PCB *current)
+{
+	uint64_t candidate = (current != NULL) ? current->vruntime : (uint64_t)-1;
+	if (heap_size[cpu] > 0 && heap[cpu][0]->vruntime < candidate) {
+		candidate = heap[cpu][0]->vruntime;
+	}
+	if (candidate != (uint64_t)-1 && candidate > min_vruntime[cpu]) {
+		min_vruntime[cpu] = candidate;
+	}
+}
+
+void rq_init(void)
+{
+	for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		heap_size[cpu]    = 0;
+		queue_weight[cpu] = 0;
+		min_vruntime[cpu] = 0;
+		batch_head[cpu]   = NULL;
+		batch_tail[cpu]   = NULL;
+		batch_count[cpu]  = 0;
+	}
+}
+
+// Todo o nada: si no hay memoria para alguna CPU, ninguna cambia de arreglo
+int rq_reserve(uint32_t capacity)
+{
+	if (capacity <= heap_capacity) {
+		return 0;
+	}
+
+	memory_manager_ADT mm   = get_kernel_memory_manager();
+	int                cpus = smp_cpu_count();
+	PCB              **grown[MAX_CPUS];
+	for (int cpu = 0; cpu < cpus; cpu++) {
+		grown[cpu] = alloc_memory(mm, capacity * sizeof(PCB *));
+		if (grown[cpu] == NULL) {
+			while (cpu-- > 0) {
+				free_memory(mm, grown[cpu]);
+			}
+			return -1;
+		}
+	}
+
+	for (int cpu = 0; cpu < cpus; cpu++) {
+		if (heap[cpu] != NULL) {
+			memcpy(grown[cpu], heap[cpu], heap_size[cpu] * sizeof(PCB *));
+			free_memory(mm, heap[cpu]);
+		}
+		heap[cpu] = grown[cpu];
+	}
+	heap_capacity = capacity;
+	return 0;
+}
+
+static void batch_enqueue(PCB *p)
+{
+	int cpu    = p->cpu;
+	p->rq_next = NULL;
+	p->rq_prev = batch_tail[cpu];
+	if (batch_tail[cpu] != NULL) {
+		batch_tail[cpu]->rq_next = p;
+	} else {
+		batch_head[cpu] = p;
+	}
+	batch_tail[cpu] = p;
+	batch_count[cpu]++;
+}
+
+static void batch_remove(PCB *p)
+{
+	int cpu = p->cpu;
+	if (p->rq_prev != NULL) {
+		p->rq_prev->rq_next = p->rq_next;
+	} else {
+		batch_head[cpu] = p->rq_next;
+	}
+	if (p->rq_next != NULL) {
+		p->rq_next->rq_prev = p->rq_prev;
+	} else {
+		batch_tail[cpu] = p->rq_prev;
+	}
+	p->rq_next = NULL;
+	p->rq_prev = NULL;
+	batch_count[cpu]--;
+}
+
+// O(log n) (O(1) para los batch)
+void rq_enqueue(PCB *p)
+{
+	if (p->on_rq) {
+		return;
+	}
+
+	p->on_rq = true;
+	if (rq_is_batch(p)) {
+		p->rq_level = BATCH_QUEUE;
+		batch_enqueue(p);
+		return;
+	}
+	p->rq_level = HEAP_QUEUE;
+
+	// Un proceso nuevo o que estuvo bloqueado no puede acumular ventaja infinita: se lo ubica
+	// apenas por delante del mínimo de la CPU
+	uint64_t floor = min_vruntime[p->cpu] > SLEEPER_CREDIT_NS
+	                         ? min_vruntime[p->cpu] - SLEEPER_CREDIT_NS
+	                         : 0;
+	if (p->vruntime < floor) {
+		p->vruntime = floor;
+	}
+
+	PCB    **h = heap[p->cpu];
+	uint32_t i = heap_size[p->cpu]++;
+	h[i]        = p;
+	p->rq_index = i;
+	queue_weight[p->cpu] += weight_of(p);
+	sift_up(h, i);
+}
+
+// O(log n) (O(1) para los batch)
+void rq_remove(PCB *p)
+{
+	if (!p->on_rq) {
+		return;
+	}
+
+	p->on_rq = false;
+	if (p->rq_level == BATCH_QUEUE) {
+		batch_remove(p);
+		return;
+	}
+
+	int      cpu  = p->cpu;
+	PCB    **h    = heap[cpu];
+	uint32_t i    = p->rq_index;
+	uint32_t last = --heap_size[cpu];
+
+	if (i != last) {
+		heap_swap(h, i, last);
+		sift_down(h, last, i);
+		sift_up(h, i);
+	}
+
+	queue_weight[cpu] -= weight_of(p);
+}
+
+// El de menor vruntime es la raíz del heap; si está vacío, el primero de la cola batch
+PCB *rq_pick(int cpu)
+{
+	PCB *p = heap_size[cpu] > 0 ? heap[cpu][0] : batch_head[cpu];
+	if (p != NULL) {
+		rq_remove(p);
+	}
+	return p;
+}
+
+uint32_t rq_count(int cpu)
+{
+	return heap_size[cpu] + batch_count[cpu];
+}
+
+// El vruntime es relativo al min_vruntime de cada CPU: se traslada para que el proceso no llegue
+// con ventaja ni con deuda a la nueva
+void rq_migrate(PCB *p, int cpu)
+{
+	uint64_t relative = p->vruntime > min_vruntime[p->cpu] ? p->vruntime - min_vruntime[p->cpu]
+	                                                        : 0;
+	p->vruntime = min_vruntime[cpu] + relative;
+	p->cpu      = cpu;
+}
+
+// Desaloja si el primero de la cola corrió bastante menos (en tiempo virtual) que el actual. A uno
+// batch lo desaloja cualquier proceso normal; uno batch no desaloja a nadie.
+bool rq_should_preempt(int cpu, PCB *current)
+{
+	if (heap_size[cpu] == 0) {
+		return false;
+	}
+	if (rq_is_batch(current)) {
+		return true;
+	}
+	return current->vruntime > heap[cpu][0]->vruntime + WAKEUP_GRANULARITY_NS;
+}
+
+void rq_update_current(PCB *current)
+{
+	uint64_t now   = clock_ns();
+	uint64_t delta = now - current->exec_start;
+
+	current->exec_start = now;
+	if (rq_is_batch(current)) {
+		return;
+	}
+
+	current->vruntime += delta * NICE_0_WEIGHT / weight_of(current);
+	update_min_vruntime(current->cpu, current);
+}
+
+// Cada proceso corre una parte de SCHED_LATENCY_TICKS proporcional a su peso (mínimo 1 tick); uno
+// batch, BATCH_QUANTUM
+uint32_t rq_set_running(int cpu, PCB *p)
+{
+	p->exec_start = clock_ns();
+	if (rq_is_batch(p)) {
+		return BATCH_QUANTUM;
+	}
+	update_min_vruntime(cpu, p);
+
+	uint64_t total = queue_weight[cpu] + weight_of(p);
+	uint64_t slice = SCHED_LATENCY_TICKS * weight_of(p) / total;
+	return slice > 0 ? slice : 1;
+}
+
+void rq_put_prev(PCB *p, bool slice_expired)
+{
+	// La prioridad solo define el peso: no hay niveles que cambiar
+}
+
+void rq_wakeup(PCB *p, bool io)
+{
+	// El crédito de los que vuelven de estar bloqueados se aplica al encolarlos
+}
+
+// Si está corriendo, lo que corrió hasta ahora se cobra con el peso anterior
+void rq_set_inherited(PCB *p, uint8_t priority)
+{
+	if (p->running_on != NO_CPU) {
+		rq_update_current(p);
+	}
+	p->pi_priority = priority;
+}
+
+void rq_aging(int cpu, uint64_t now)
+{
+	// El runtime virtual ya evita la inanición: no hace falta promover procesos
+}
+
+int rq_set_quantum(uint8_t priority, uint32_t ticks)
+{
+	return -1; // el largo de cada turno sale de los pesos
+}
+
+int rq_get_quantum(uint8_t priority)
+{
+	return -1;
+}
@@ -0,0 +1,185 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Clase de tiempo real EDF. Se compila siempre, sobre cualquiera de las dos políticas: un proceso
+// de esta clase nunca está en las colas READY de la política, solo en la lista de su CPU.
+#include "deadline.h"
+#include "scheduler.h"
+#include "smp.h"
+#include <stddef.h>
+
+// Procesos de tiempo real de cada CPU (lista intrusiva por dl_next), listos o no. Son pocos, así
+// que elegir el próximo es un recorrido lineal.
+static PCB     *members[MAX_CPUS];
+static uint32_t member_count[MAX_CPUS];
+static uint32_t bandwidth[MAX_CPUS]; // suma de runtime/deadline en DL_UNIT
+
+void dl_init(void)
+{
+	for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		members[cpu]      = NULL;
+		member_count[cpu] = 0;
+		bandwidth[cpu]    = 0;
+	}
+}
+
+// Redondea para arriba: la admisión nunca subestima lo que el proceso reserva
+static uint32_t density(uint32_t runtime, uint32_t deadline)
+{
+	return (uint32_t)(((uint64_t)runtime * DL_UNIT + deadline - 1) / deadline);
+}
+
+static void unlink_member(PCB *p)
+{
+	PCB **it = &members[p->cpu];
+	while (*it != NULL && *it != p) {
+		it = &(*it)->dl_next;
+	}
+	if (*it == p) {
+		*it = p->dl_next;
+		member_count[p->cpu]--;
+		bandwidth[p->cpu] -= p->dl_bandwidth;
+	}
+	p->dl_next = NULL;
+}
+
+// Empieza un período nuevo en start: budget completo y deadline absoluto desde start. Lo que el
+// proceso corrió hasta now era del período anterior y no se descuenta del budget nuevo.
+static void release_job(PCB *p, uint64_t start, uint64_t now)
+{
+	p->dl_abs_deadline = start + p->dl_deadline;
+	p->dl_next_release = start + p->dl_period;
+	p->dl_budget       = p->dl_runtime;
+	p->dl_last_update  = now;
+	p->dl_done         = false;
+	p->dl_miss_counted = false;
+}
+
+static inline bool dl_runnable(PCB *p)
+{
+	return p->dl_budget > 0 && !p->dl_done;
+}
+
+int dl_set_params(PCB *p, uint32_t runtime, uint32_t period, uint32_t deadline, uint64_t now)
+{
+	if (runtime == 0) {
+		if (dl_is_member(p)) {
+			dl_detach(p);
+		}
+		return p->cpu;
+	}
+
+	if (deadline == 0) {
+		deadline = period;
+	}
+	if (period == 0 || period > MAX_DL_PERIOD || deadline > period || runtime > deadline) {
+		return NO_CPU;
+	}
+
+	// La CPU con más lugar libre (contando lo que el proceso ya tenía reservado en la suya)
+	uint32_t need = density(runtime, deadline);
+	int      best = NO_CPU;
+	uint32_t most = 0;
+	for (int i = 0; i < smp_cpu_count(); i++) {
+		uint32_t used = bandwidth[i];
+		if (dl_is_member(p) && p->cpu == i) {
+			used -= p->dl_bandwidth;
+		}
+		uint32_t free = DL_UNIT - used;
+		if (free >= need && (best == NO_CPU || free > most)) {
+			best = i;
+			most = free;
+		}
+	}
+	if (best == NO_CPU) {
+		return NO_CPU;
+	}
+
+	if (dl_is_member(p)) {
+		unlink_member(p);
+	}
+
+	p->cpu          = best;
+	p->dl_runtime   = runtime;
+	p->dl_period    = period;
+	p->dl_deadline  = deadline;
+	p->dl_bandwidth = need;
+	p->dl_next      = members[best];
+	members[best]   = p;
+	member_count[best]++;
+	bandwidth[best] += need;
+
+	release_job(p, now, now);
+	return best;
+}
+
+void dl_detach(PCB *p)
+{
+	if (!dl_is_member(p)) {
+		return;
+	}
+	unlink_member(p);
+	p->dl_period = 0;
+}
+
+void dl_tick(int cpu, uint64_t now)
+{
+	for (PCB *p = members[cpu]; p != NULL; p = p->dl_next) {
+		if (!p->dl_done && !p->dl_miss_counted && now >= p->dl_abs_deadline) {
+			p->dl_missed++;
+			p->dl_miss_counted = true;
+		}
+		if (now >= p->dl_next_release) {
+			// Si se pasó más de un período (el tick no llegó a tiempo) se realinea al actual
+			uint64_t late = (now - p->dl_next_release) / p->dl_period;
+			release_job(p, p->dl_next_release + late * p->dl_period, now);
+		}
+	}
+}
+
+PCB *dl_pick(int cpu)
+{
+	PCB *best = NULL;
+	for (PCB *p = members[cpu]; p != NULL; p = p->dl_next) {
+		if (p->status == PS_READY && dl_runnable(p) &&
+		    (best == NULL || p->dl_abs_deadline < best->dl_abs_deadline)) {
+			best = p;
+		}
+	}
+	return best;
+}
+
+bool dl_should_preempt(int cpu, PCB *current)
+{
+	if (dl_is_member(current) && !dl_runnable(current)) {
+		return true;
+	}
+	PCB *candidate = dl_pick(cpu);
+	if (candidate == NULL) {
+		return false;
+	}
+	return !dl_is_member(current) || candidate->dl_abs_deadline < current->dl_abs_deadline;
+}
+
+uint32_t dl_set_running(PCB *p, uint64_t now)
+{
+	p->dl_last_update = now;
+	return p->dl_budget;
+}
+
+void dl_update_current(PCB *p, uint64_t now)
+{
+	uint64_t used     = now - p->dl_last_update;
+	p->dl_budget      = (used >= p->dl_budget) ? 0 : p->dl_budget - (uint32_t)used;
+	p->dl_last_update = now;
+}
+
+void dl_job_done(PCB *p)
+{
+	p->dl_done = true;
+}
+
+uint32_t dl_count(int cpu)
+{
+	return member_count[cpu];
+}
@@ -0,0 +1,228 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "runqueue.h"
+#include "scheduler.h"
+#include "smp.h"
+#include <stddef.h>
+
+// Multi-level feedback queue: effective_priority es el nivel en el que está el proceso, entre su
+// prioridad base (nice) y MIN_PRIORITY. Baja un nivel cuando gasta todo su quantum (aunque lo gaste
+// en varios turnos), vuelve a su prioridad base al despertarse de una lectura de teclado o de pipe,
+// y cada MLFQ_BOOST_INTERVAL ticks los procesos encolados vuelven a su prioridad base para que un
+// proceso relegado no se quede sin CPU. Un proceso con prioridad heredada (pi_priority) no baja
+// de ese nivel mientras la tenga. Los procesos batch van a una cola más, BATCH_LEVEL, por debajo
+// de todas: el bitmap los elige solo si las demás están vacías y el boost no los recorre.
+
+#define BATCH_LEVEL PRIORITY_COUNT
+#define LEVEL_COUNT (PRIORITY_COUNT + 1)
+
+// Cola READY intrusiva: los enlaces viven dentro de cada PCB, así que encolar y desencolar
+// no aloca ni libera memoria
+typedef struct run_queue {
+	PCB *head;
+	PCB *tail;
+} run_queue_t;
+
+// Colas READY por CPU. Todo el estado se modifica con el lock del kernel tomado.
+static run_queue_t ready_queue[MAX_CPUS][LEVEL_COUNT];
+static uint32_t    ready_bitmap[MAX_CPUS]; // bit i encendido <=> ready_queue[cpu][i] no vacía
+static uint32_t    ready_count[MAX_CPUS];  // procesos encolados en cada CPU
+
+// Largo del quantum (en ticks) de cada nivel de prioridad, modificable con sys_set_quantum
+static uint32_t quantum[PRIORITY_COUNT] = {
+        MAX_PRIORITY_QUANTUM, DEFAULT_PRIORITY_QUANTUM, MIN_PRIORITY_QUANTUM};
+
+static uint64_t last_boost[MAX_CPUS]; // ticks de CPU del último reseteo de prioridades
+
+// Nivel al que vuelve el proceso: su prioridad base, o la heredada si es mayor
+static inline uint8_t base_level(PCB *p)
+{
+	return p->pi_priority < p->priority ? p->pi_priority : p->priority;
+}
+
+// Cola en la que se encola el proceso
+static inline uint8_t queue_level(PCB *p)
+{
+	return rq_is_batch(p) ? BATCH_LEVEL : p->effective_priority;
+}
+
+void rq_init(void)
+{
+	// no alocan memoria, solo se vacían
+	for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+		for (int i = 0; i < LEVEL_COUNT; i++) {
+			ready_queue[cpu][i].head = NULL;
+			ready_queue[cpu][i].tail = NULL;
+		}
+		ready_bitmap[cpu] = 0;
+		ready_count[cpu]  = 0;
+		last_boost[cpu]   = 0;
+	}
+}
+
+int rq_reserve(uint32_t capacity)
+{
+	return 0; // las colas están enlazadas por los PCBs
+}
+
+// Agrega el proceso al final de la cola de su prioridad efectiva (o la batch) en su CPU. O(1)
+void rq_enqueue(PCB *p)
+{
+	if (p->on_rq) {
+		return;
+	}
+
+	run_queue_t *rq = &ready_queue[p->cpu][queue_level(p)];
+	p->rq_level     = queue_level(p);
+	p->rq_next      = NULL;
+	p->rq_prev      = rq->tail;
+	if (rq->tail != NULL) {
+		rq->tail->rq_next = p;
+	} else {
+		rq->head = p;
+	}
+	rq->tail = p;
+
+	p->on_rq = true;
+	ready_bitmap[p->cpu] |= (1u << p->rq_level);
+	ready_count[p->cpu]++;
+}
+
+// Saca al proceso de la cola READY en la que esté (si está encolado). O(1)
+// p->cpu no cambia mientras el proceso está encolado
+void rq_remove(PCB *p)
+{
+	if (!p->on_rq) {
+		return;
+	}
+
+	run_queue_t *rq = &ready_queue[p->cpu][p->rq_level];
+	if (p->rq_prev != NULL) {
+		p->rq_prev->rq_next = p->rq_next;
+	} else {
+		rq->head = p->rq_next;
+	}
+	if (p->rq_next != NULL) {
+		p->rq_next->rq_prev = p->rq_prev;
+	} else {
+		rq->tail = p->rq_prev;
+	}
+
+	p->rq_next = NULL;
+	p->rq_prev = NULL;
+	p->on_rq   = false;
+	if (rq->head == NULL) {
+		ready_bitmap[p->cpu] &= ~(1u << p->rq_level);
+	}
+	ready_count[p->cpu]--;
+}
+
+// La cola no vacía de mayor prioridad es el bit encendido más bajo del bitmap. O(1)
+PCB *rq_pick(int cpu)
+{
+	if (ready_bitmap[cpu] == 0) {
+		return NULL;
+	}
+
+	int  priority  = __builtin_ctz(ready_bitmap[cpu]);
+	PCB *candidate = ready_queue[cpu][priority].head;
+	rq_remove(candidate);
+	return candidate;
+}
+
+uint32_t rq_count(int cpu)
+{
+	return ready_count[cpu];
+}
+
+void rq_migrate(PCB *p, int cpu)
+{
+	p->cpu = cpu;
+}
+
+// Desaloja si hay un proceso listo de mayor prioridad en esta CPU (a uno batch, cualquier normal)
+bool rq_should_preempt(int cpu, PCB *current)
+{
+	return (ready_bitmap[cpu] & ((1u << queue_level(current)) - 1)) != 0;
+}
+
+void rq_update_current(PCB *current)
+{
+	// Con quantums fijos alcanza con contar ticks (ticks_left en scheduler.c)
+}
+
+// Lo que no usó de su quantum lo conserva para el próximo turno: ceder la CPU justo antes de
+// agotarlo no evita que baje de nivel
+uint32_t rq_set_running(int cpu, PCB *p)
+{
+	if (p->ticks_left == 0) {
+		p->ticks_left = rq_is_batch(p) ? BATCH_QUANTUM : quantum[p->effective_priority];
+	}
+	return p->ticks_left;
+}
+
+// Gastó todo su quantum: es CPU-bound, baja un nivel (uno batch ya está en la última cola)
+void rq_put_prev(PCB *p, bool slice_expired)
+{
+	if (slice_expired && !rq_is_batch(p) && p->effective_priority < p->pi_priority) {
+		p->effective_priority++;
+	}
+}
+
+// Se despertó de una lectura de teclado o de pipe: es interactivo, vuelve a su prioridad base con
+// un quantum nuevo
+void rq_wakeup(PCB *p, bool io)
+{
+	if (io) {
+		p->effective_priority = base_level(p);
+		p->ticks_left         = 0;
+	}
+}
+
+// Cada MLFQ_BOOST_INTERVAL ticks de CPU, todos los encolados en la CPU vuelven a su prioridad base
+void rq_aging(int cpu, uint64_t now)
+{
+	if (now - last_boost[cpu] < MLFQ_BOOST_INTERVAL) {
+		return;
+	}
+	last_boost[cpu] = now;
+
+	// Se mueven a niveles ya recorridos, así que cada proceso se visita una sola vez
+	for (int i = MAX_PRIORITY + 1; i <= MIN_PRIORITY; i++) {
+		PCB *p = ready_queue[cpu][i].head;
+		while (p != NULL) {
+			PCB *next = p->rq_next; // guardarlo antes de mover p a otra cola
+			if (p->effective_priority != base_level(p)) {
+				rq_remove(p);
+				p->effective_priority = base_level(p);
+				p->ticks_left         = 0;
+				rq_enqueue(p);
+			}
+			p = next;
+		}
+	}
+}
+
+// Sube al nivel heredado; al perder la herencia vuelve a no estar por encima de su prioridad base
+void rq_set_inherited(PCB *p, uint8_t priority)
+{
+	p->pi_priority = priority;
+	if (p->effective_priority > priority) {
+		p->effective_priority = priority;
+	} else if (p->effective_priority < base_level(p)) {
+		p->effective_priority = base_level(p);
+	}
+}
+
+int rq_set_quantum(uint8_t priority, uint32_t ticks)
+{
+	// Se aplica a partir del próximo quantum que se asigne en ese nivel
+	quantum[priority] = ticks;
+	return 0;
+}
+
+int rq_get_quantum(uint8_t priority)
+{
+	return quantum[priority];
+}
@@ -2,7 +2,7 @@
 // PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
 
 #include "queue.h"
-#include "memory_manager.h"
+#include "slab.h"
 
 typedef struct node {
 	int          value;
@@ -16,25 +16,30 @@ typedef struct queue_cdt {
 	node_t *prev_current; // Para iterador: nodo previo al actual (para poder remover)
 } queue_cdt;
 
-queue_t q_init()
+static void queue_ctor(void *object);
+
+// Las queues vuelven al cache vacías (q_destroy), así que q_init no tiene que inicializarlas
+static slab_cache_t queue_cache = SLAB_CACHE("queue", queue_cdt, &queue_ctor);
+static slab_cache_t node_cache  = SLAB_CACHE("queue_node", node_t, NULL);
+
+static void queue_ctor(void *object)
 {
-	memory_manager_ADT mm = get_kernel_memory_manager();
-	queue_t            q  = alloc_memory(mm, sizeof(queue_cdt));
-	if (q == NULL) {
-		return NULL;
-	}
+	queue_t q       = object;
 	q->first        = NULL;
 	q->last         = NULL;
 	q->current      = NULL;
 	q->prev_current = NULL;
-	return q;
+}
+
+queue_t q_init()
+{
+	return slab_alloc(&queue_cache);
 }
 
 // devuelve 1 si lo agrego, 0 sino (si se puede cambiar a bool)
 int q_add(queue_t q, int value)
 {
-	memory_manager_ADT mm       = get_kernel_memory_manager();
-	node_t            *new_node = alloc_memory(mm, sizeof(node_t));
+	node_t *new_node = slab_alloc(&node_cache);
 	if (new_node == NULL) {
 		return 0;
 	}
@@ -58,11 +63,10 @@ int q_poll(queue_t q)
 	if (q_is_empty(q)) {
 		return -1;
 	}
-	memory_manager_ADT mm      = get_kernel_memory_manager();
-	int                res     = q->first->value;
-	node_t            *to_free = q->first;
-	q->first                   = to_free->next;
-	free_memory(mm, to_free);
+	int     res     = q->first->value;
+	node_t *to_free = q->first;
+	q->first        = to_free->next;
+	slab_free(&node_cache, to_free);
 	if (q->first == NULL) {
 		q->last = NULL;
 	}
@@ -76,11 +80,10 @@ int q_remove(queue_t q, int value)
 	if (q_is_empty(q)) {
 		return 0;
 	}
-	memory_manager_ADT mm = get_kernel_memory_manager();
 	if (q->first->value == value) {
 		node_t *to_free = q->first;
 		q->first        = q->first->next;
-		free_memory(mm, to_free);
+		slab_free(&node_cache, to_free);
 		if (q_is_empty(q)) {
 			q->last = NULL;
 		}
@@ -91,7 +94,7 @@ int q_remove(queue_t q, int value)
 	while (current != NULL) {
 		if (current->value == value) {
 			prev->next = current->next;
-			free_memory(mm, current);
+			slab_free(&node_cache, current);
 			if (prev->next == NULL) {
 				q->last = prev;
 			}
@@ -135,14 +138,14 @@ void q_destroy(queue_t q)
 		return;
 	}
 
-	memory_manager_ADT mm      = get_kernel_memory_manager();
-	node_t            *current = q->first;
+	node_t *current = q->first;
 	while (current != NULL) {
 		node_t *next = current->next;
-		free_memory(mm, current);
+		slab_free(&node_cache, current);
 		current = next;
 	}
-	free_memory(mm, q);
+	queue_ctor(q);
+	slab_free(&queue_cache, q);
 }
 
 // Inicializa el iterador al comienzo de la queue
@@ -187,8 +190,7 @@ int q_remove_current(queue_t q)
 		return 0;
 	}
 
-	memory_manager_ADT mm        = get_kernel_memory_manager();
-	node_t            *to_remove = q->prev_current;
+	node_t *to_remove = q->prev_current;
 
 	// Caso 1: el nodo a remover es el primero
 	if (to_remove == q->first) {
@@ -196,7 +198,7 @@ int q_remove_current(queue_t q)
 		if (q->first == NULL) {
 			q->last = NULL;
 		}
-		free_memory(mm, to_remove);
+		slab_free(&node_cache, to_remove);
 		q->prev_current = NULL;
 		return 1;
 	}
@@ -220,7 +222,7 @@ int q_remove_current(queue_t q)
 		q->last = prev;
 	}
 
-	free_memory(mm, to_remove);
+	slab_free(&node_cache, to_remove);
 	q->prev_current = NULL;
 
 	return 1;
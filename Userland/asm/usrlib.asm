@@ -5,10 +5,20 @@ global  sys_enable_textmode, sys_disable_textmode, sys_put_pixel, sys_key_status
 global  sys_sleep, sys_clear_input_buffer, sys_ticks
 global  sys_malloc, sys_free, sys_mem_info
 ; Process/syscalls (scheduler-backed)
-global  sys_create_process, sys_exit_current, sys_getpid, sys_kill, sys_block, sys_unblock, sys_wait, sys_nice, sys_processes_info, sys_yield
+global  sys_create_process, sys_create_process_stack, sys_exit_current, sys_getpid, sys_kill, sys_block, sys_unblock, sys_wait, sys_nice, sys_processes_info, sys_yield
 global sys_sem_open,sys_sem_close,sys_sem_wait,sys_sem_post
 global sys_create_pipe, sys_destroy_pipe, sys_open_named_pipe, sys_close_fd, sys_pipes_info
 global sys_set_foreground_process, sys_adopt_init_as_parent, sys_get_foreground_process
+global sys_sched_stats, sys_set_quantum
+global sys_clock_ns, sys_nanosleep
+global sys_sched_deadline
+global sys_waitany
+global sys_set_group, sys_group_quota, sys_groups_info
+global sys_set_batch
+global sys_thread_create, sys_thread_join
+global sys_slab_info
+global sys_mutex_open
+global sys_process_info, sys_process_count
 global generate_invalid_opcode
 global printf
 global scanf
@@ -127,8 +137,13 @@ sys_free:
 sys_mem_info:
     SYSCALL 25
 
-; 26 - int64_t sys_create_process(void *entry, int argc, const char **argv, const char *name)
+; 26 - int64_t sys_create_process(void *entry, int argc, const char **argv, const char *name, int fds[2])
 sys_create_process:
+    xor     r9, r9      ; stack de tamaño por defecto
+    SYSCALL 26
+
+; 26 - int64_t sys_create_process_stack(void *entry, int argc, const char **argv, const char *name, int fds[2], uint64_t stack_size)
+sys_create_process_stack:
     SYSCALL 26
 
 ; 27 - void sys_exit_current(int status), NO SE USA POR AHORA
@@ -216,6 +231,70 @@ sys_close_fd:
 sys_pipes_info:
     SYSCALL 47
 
+; 48 - int sys_sched_stats(sched_stats_t * buf);
+sys_sched_stats:
+    SYSCALL 48
+
+; 49 - int sys_set_quantum(uint8_t priority, uint32_t ticks);
+sys_set_quantum:
+    SYSCALL 49
+
+; 50 - uint64_t sys_clock_ns(void);
+sys_clock_ns:
+    SYSCALL 50
+
+; 51 - void sys_nanosleep(uint64_t nanoseconds);
+sys_nanosleep:
+    SYSCALL 51
+
+; 52 - int sys_sched_deadline(uint32_t runtime, uint32_t period, uint32_t deadline);
+sys_sched_deadline:
+    SYSCALL 52
+
+; 53 - int64_t sys_waitany(int64_t *status);
+sys_waitany:
+    SYSCALL 53
+
+; 54 - int sys_set_group(int pid, int group);
+sys_set_group:
+    SYSCALL 54
+
+; 55 - int sys_group_quota(int group, uint32_t quota, uint32_t period);
+sys_group_quota:
+    SYSCALL 55
+
+; 56 - int sys_groups_info(group_info_t *buf, int max_count);
+sys_groups_info:
+    SYSCALL 56
+
+; 57 - int sys_set_batch(int pid, bool batch);
+sys_set_batch:
+    SYSCALL 57
+
+; 58 - int64_t sys_thread_create(thread_entry_t entry, void *arg, uint64_t stack_size);
+sys_thread_create:
+    SYSCALL 58
+
+; 59 - int sys_thread_join(int tid, int64_t *status);
+sys_thread_join:
+    SYSCALL 59
+
+; 60 - int sys_slab_info(slab_info_t *buf, int max_count);
+sys_slab_info:
+    SYSCALL 60
+
+; 61 - int64_t sys_mutex_open(const char *name);
+sys_mutex_open:
+    SYSCALL 61
+
+; 62 - int sys_process_info(int pid, process_info_t *info);
+sys_process_info:
+    SYSCALL 62
+
+; 63 - int sys_process_count(void);
+sys_process_count:
+    SYSCALL 63
+
 generate_invalid_opcode:
     ud2         ; Genera excepción de opcode inválido
     ret
@@ -23,5 +23,8 @@ int kill_main(int argc, char *argv[]);
 int block_main(int argc, char *argv[]);
 int unblock_main(int argc, char *argv[]);
 int nice_main(int argc, char *argv[]);
+int quantum_main(int argc, char *argv[]);
+int group_main(int argc, char *argv[]);
+int cpuquota_main(int argc, char *argv[]);
 
 #endif
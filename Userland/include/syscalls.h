@@ -3,19 +3,29 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 #define OK 0
 #define ERROR -1
 #define EOF -1
 #define MAX_NAME_LENGTH 32
-#define MAX_PROCESSES 64
+#define MAX_PROCESSES 4096
+#define MAX_STACK_SIZE (4096 * 16)
 
 #define MIN_PRIORITY 2
 #define MAX_PRIORITY 0
 
+#define WAIT_HIST_BUCKETS 20 // bucket i: esperas en READY de [2^i, 2^(i+1)) us
+
 #define MAX_PIPES 32
 #define MAX_PIPE_NAME_LENGTH 32
 
+#define MAX_GROUPS 16
+
+#define MAX_SLAB_CACHES 16
+#define SLAB_NAME_LENGTH 16
+#define ROOT_GROUP 0
+
 enum { STDIN = 0, STDOUT, STDERR, STDGREEN, STDBLUE, STDCYAN, STDMAGENTA, STDYELLOW, FDS_COUNT };
 
 typedef struct mem_info {
@@ -25,7 +35,18 @@ typedef struct mem_info {
 	size_t allocated_blocks;
 } mem_info_t;
 
+// Un cache de objetos del kernel (los objetos de tamaño fijo no pasan por el heap general)
+typedef struct slab_info {
+	char     name[SLAB_NAME_LENGTH];
+	uint32_t object_size;
+	uint32_t objects;   // alocados
+	uint32_t capacity;  // objetos en todos sus slabs (alocados y libres)
+	uint32_t slabs;     // slabs pedidos al memory manager
+	uint32_t slab_size; // bytes de cada slab
+} slab_info_t;
+
 typedef int (*process_entry_t)(int argc, char **argv);
+typedef int (*thread_entry_t)(void *arg);
 
 typedef enum { PS_READY = 0, PS_RUNNING, PS_BLOCKED, PS_TERMINATED } process_status_t;
 
@@ -39,8 +60,44 @@ typedef struct process_info {
 	int              write_fd;
 	uint64_t         stack_base;
 	uint64_t         stack_pointer;
+	uint64_t         voluntary_switches;
+	uint64_t         involuntary_switches;
+	uint64_t         cpu_ticks;
+	uint64_t         wakeups;
+	uint64_t         wait_total_ns;
+	uint64_t         wait_max_ns;
+	uint32_t         wait_hist[WAIT_HIST_BUCKETS];
+	int              cpu;
+	bool             deadline;
+	bool             batch;
+	int              owner_pid; // proceso del hilo (su propio PID si no es un hilo)
+	uint32_t         missed_deadlines;
+	int              group;
 } process_info_t;
 
+typedef struct group_info {
+	int      id;
+	uint32_t quota;       // ticks de CPU por período (0: sin límite)
+	uint32_t period;      // ticks
+	uint32_t period_used; // ticks usados en el período actual
+	uint64_t total_ticks; // ticks de CPU usados desde el arranque
+	uint64_t throttles;   // veces que gastó la cuota antes de que termine el período
+	uint32_t processes;
+	bool     throttled;
+} group_info_t;
+
+typedef struct sched_stats {
+	uint64_t ticks;
+	uint64_t total_cycles;
+	uint64_t last_cycles;
+	uint64_t max_cycles;
+	uint64_t ready_count;
+	uint64_t cpu_count;
+	uint64_t migrations;
+	uint64_t idle_wakeups;
+	uint64_t fpu_traps;
+} sched_stats_t;
+
 typedef struct pipe_info {
 	int  id;
 	char name[MAX_PIPE_NAME_LENGTH];
@@ -80,19 +137,34 @@ extern uint64_t sys_ticks();
 extern void      *sys_malloc(uint64_t size);
 extern void       sys_free(void *ptr);
 extern mem_info_t sys_mem_info(void);
+extern int        sys_slab_info(slab_info_t *buf, int max_count);
 
 // syscalls de procesos
 extern int64_t
 sys_create_process(void *entry, int argc, const char **argv, const char *name, int fds[2]);
+// Igual que sys_create_process con un stack de stack_size bytes (se redondea a una potencia de 2 de
+// 4 KB a 64 KB; 0 usa el de 8 KB, más grande falla)
+extern int64_t sys_create_process_stack(void        *entry,
+                                        int          argc,
+                                        const char **argv,
+                                        const char  *name,
+                                        int          fds[2],
+                                        uint64_t     stack_size);
 extern void    sys_exit(int status);
 extern int64_t sys_getpid(void);
 extern int64_t sys_kill(int pid);
 extern int64_t sys_block(int pid);
 extern int64_t sys_unblock(int pid);
 extern int64_t sys_wait(int pid);
+// Espera a que termine cualquier hijo: devuelve su pid (-1 si no tiene) y su valor de retorno
+extern int64_t sys_waitany(int64_t *status);
 extern int64_t sys_nice(int pid, int new_prio);
 extern void    sys_yield();
 extern int     sys_processes_info(process_info_t *buf, int max_count);
+// 0, o -1 si no hay un proceso con ese pid
+extern int     sys_process_info(int pid, process_info_t *info);
+// Procesos e hilos que hay ahora, para dimensionar el buffer de sys_processes_info
+extern int     sys_process_count(void);
 
 // syscalls para foreground process
 extern int sys_set_foreground_process(int pid);
@@ -101,6 +173,8 @@ extern int sys_get_foreground_process(void);
 
 // syscalls de semaforos
 extern int64_t sys_sem_open(const char *name, int value);
+// Como sys_sem_open pero crea un mutex (valor inicial 1) con herencia de prioridad
+extern int64_t sys_mutex_open(const char *name);
 extern void    sys_sem_close(const char *name);
 extern void    sys_sem_wait(const char *name);
 extern void    sys_sem_post(const char *name);
@@ -112,4 +186,33 @@ extern int  sys_open_named_pipe(char *name, int fds[2]);
 extern int  sys_close_fd(int fd);
 extern int  sys_pipes_info(pipe_info_t *buf, int max_count);
 
+// syscalls de estadísticas del scheduler
+extern int sys_sched_stats(sched_stats_t *buf);
+extern int sys_set_quantum(uint8_t priority, uint32_t ticks); // ticks == 0: solo consulta
+
+// syscalls de reloj de alta resolución
+extern uint64_t sys_clock_ns(void); // ns desde el arranque, monotónico
+extern void     sys_nanosleep(uint64_t nanoseconds);
+
+// syscalls de la clase de tiempo real (EDF). Parámetros en ticks; deadline 0 = period; runtime 0
+// vuelve a la clase normal. Devuelve -1 si la CPU no puede garantizar el deadline.
+extern int sys_sched_deadline(uint32_t runtime, uint32_t period, uint32_t deadline);
+
+// syscalls de grupos con cuota de CPU. Los hijos heredan el grupo del padre; un grupo con cuota
+// corre a lo sumo quota ticks de CPU cada period ticks (quota 0: sin límite; ROOT_GROUP no admite
+// cuota)
+extern int sys_set_group(int pid, int group);
+extern int sys_group_quota(int group, uint32_t quota, uint32_t period);
+extern int sys_groups_info(group_info_t *buf, int max_count);
+
+// syscall de la clase batch: el proceso corre solo cuando no hay procesos normales listos (sus
+// hijos la heredan)
+extern int sys_set_batch(int pid, bool batch);
+
+// syscalls de hilos: comparten los fds, el grupo y el tiempo de CPU del proceso, y terminan con
+// él. sys_thread_join espera a un hilo del mismo proceso y deja su valor de retorno en status.
+// stack_size 0: el tamaño por defecto
+extern int64_t sys_thread_create(thread_entry_t entry, void *arg, uint64_t stack_size);
+extern int     sys_thread_join(int tid, int64_t *status);
+
 #endif
\ No newline at end of file
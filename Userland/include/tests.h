@@ -6,5 +6,24 @@ int test_prio(int argc, char *argv[]);
 int test_processes(int argc, char *argv[]);
 int test_sync(int argc, char *argv[]);
 int test_pipes(int argc, char *argv[]);
+int test_sched(int argc, char *argv[]);
+int test_smp(int argc, char *argv[]);
+int test_idle(int argc, char *argv[]);
+int test_clock(int argc, char *argv[]);
+int test_fair(int argc, char *argv[]);
+int test_deadline(int argc, char *argv[]);
+int test_mlfq(int argc, char *argv[]);
+int test_fpu(int argc, char *argv[]);
+int test_pingpong(int argc, char *argv[]);
+int test_waitany(int argc, char *argv[]);
+int test_fanout(int argc, char *argv[]);
+int test_pi(int argc, char *argv[]);
+int test_stack(int argc, char *argv[]);
+int test_spawn(int argc, char *argv[]);
+int test_quota(int argc, char *argv[]);
+int test_batch(int argc, char *argv[]);
+int test_threads(int argc, char *argv[]);
+int test_slab(int argc, char *argv[]);
+int test_malloc(int argc, char *argv[]);
 
 #endif
\ No newline at end of file
@@ -47,6 +47,12 @@ int      strcmp(char *s1, char *s2);
 uint64_t num_to_str_base(uint64_t value, char *buffer, uint32_t base);
 int64_t  satoi(char *str);
 
+// FUNCIONES DE MEMORIA (los bloques chicos no pasan por el kernel, ver usrlib/malloc.c)
+void *malloc(uint64_t size);
+void  free(void *ptr);
+void *calloc(uint64_t count, uint64_t size);
+void *realloc(void *ptr, uint64_t size);
+
 //FUNCIONES DE MATEMATICAS 
 float    inv_sqrt(float number);
 uint32_t get_uint();
@@ -0,0 +1,31 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "usrlib.h"
+
+int cpuquota_main(int argc, char *argv[])
+{
+	if (argc != 1 && argc != 3) {
+		print_err("Usage: cpuquota <group> [<quota_ticks> <period_ticks>]\n");
+		print_err("  without quota and period, removes the limit of the group\n");
+		return ERROR;
+	}
+
+	int group  = satoi(argv[0]);
+	int quota  = argc == 3 ? satoi(argv[1]) : 0;
+	int period = argc == 3 ? satoi(argv[2]) : 0;
+
+	if (quota < 0 || period < 0 || sys_group_quota(group, quota, period) == ERROR) {
+		printf("Failed to change quota. Check group range (1-%d) and that 0 < quota and "
+		       "0 < period <= 1000.\n",
+		       MAX_GROUPS - 1);
+		return ERROR;
+	}
+
+	if (quota == 0) {
+		printf("Group %d has no CPU limit\n", group);
+	} else {
+		printf("Group %d limited to %d ticks every %d ticks\n", group, quota, period);
+	}
+	return OK;
+}
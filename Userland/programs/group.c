@@ -0,0 +1,24 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "usrlib.h"
+
+int group_main(int argc, char *argv[])
+{
+	if (argc != 2) {
+		print_err("Usage: group <pid> <group>\n");
+		return ERROR;
+	}
+
+	int pid   = satoi(argv[0]);
+	int group = satoi(argv[1]);
+
+	if (sys_set_group(pid, group) == ERROR) {
+		printf("Failed to change group. Check PID and group range (0-%d).\n",
+		       MAX_GROUPS - 1);
+		return ERROR;
+	}
+
+	printf("Moved process %d to group %d\n", pid, group);
+	return OK;
+}
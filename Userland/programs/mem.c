@@ -28,10 +28,70 @@ static void print_padded_int(unsigned value, int width)
 	printf("%u", value);
 }
 
+#define SLAB_NAME_WIDTH 12
+#define PROBE_MIN_SIZE 32
+#define PROBE_MAX_SIZE (64 * 1024)
+
+// Caches de objetos del kernel: objetos en uso, capacidad, slabs y qué parte de los slabs ocupan
+// los objetos en uso
+static void print_slab_caches(void)
+{
+	slab_info_t caches[MAX_SLAB_CACHES];
+	int         count = sys_slab_info(caches, MAX_SLAB_CACHES);
+
+	printf("\nObject caches:\n");
+	printf("NAME          SIZE  IN USE   TOTAL  SLABS  USE%%\n");
+	for (int i = 0; i < count; i++) {
+		slab_info_t *c     = &caches[i];
+		uint64_t     bytes = (uint64_t)c->slabs * c->slab_size;
+		uint64_t     used  = (uint64_t)c->objects * c->object_size;
+		int          len   = strlen(c->name);
+
+		printf("%s", c->name);
+		for (int j = len; j < SLAB_NAME_WIDTH; j++) {
+			putchar(' ');
+		}
+		print_padded_int(c->object_size, 6);
+		print_padded_int(c->objects, 8);
+		print_padded_int(c->capacity, 8);
+		print_padded_int(c->slabs, 7);
+		print_padded_int(bytes ? used * 100 / bytes : 0, 6);
+		putchar('\n');
+	}
+}
+
+// Pide al kernel un bloque de cada potencia de 2 y muestra cuánta memoria libre consumió (bloque y
+// metadata del memory manager): lo que pasa de lo pedido es fragmentación interna. Es aproximado si
+// otro proceso aloca al mismo tiempo.
+static int print_fragmentation(void)
+{
+	printf("REQUEST    HEAP USED   WASTE\n");
+	for (uint64_t size = PROBE_MIN_SIZE; size <= PROBE_MAX_SIZE; size *= 2) {
+		uint64_t before = sys_mem_info().free_memory;
+		void    *ptr    = sys_malloc(size);
+		if (ptr == NULL) {
+			printf("mem: could not allocate %u bytes\n", (unsigned)size);
+			return -1;
+		}
+		uint64_t used = before - sys_mem_info().free_memory;
+		sys_free(ptr);
+
+		print_padded_int(size, 7);
+		print_padded_int(used, 13);
+		print_padded_int(used > size ? (used - size) * 100 / size : 0, 7);
+		printf("%%\n");
+	}
+	return OK;
+}
+
 int mem_main(int argc, char *argv[])
 {
+	if (argc == 1 && strcmp(argv[0], "-f") == 0) {
+		return print_fragmentation();
+	}
 	if (argc != 0) {
 		printf("mem: Invalid number of arguments.\n");
+		printf("Usage: mem [-f]\n");
 		return -1;
 	}
 
@@ -66,6 +126,7 @@ int mem_main(int argc, char *argv[])
 	}
 
 	printf("Allocated blocks: %u\n", (unsigned)info.allocated_blocks);
+	print_slab_caches();
 
 	return OK;
 }
\ No newline at end of file
@@ -3,65 +3,216 @@
 
 #include "usrlib.h"
 
-int ps_main(int argc, char *argv[])
-{
-	process_info_t processes[MAX_PROCESSES];
-	int            count = sys_processes_info(processes, MAX_PROCESSES);
+#define NS_PER_US 1000
+#define HIST_BAR_WIDTH 40
+#define EXTRA_PROCESSES 8
 
-	if (count < 0) {
-		print_err("Failed to get processes info\n");
-		return 1;
+// Cantidad de veces que el proceso esperó en READY hasta correr
+static uint64_t wait_count(process_info_t *p)
+{
+	uint64_t count = 0;
+	for (int i = 0; i < WAIT_HIST_BUCKETS; i++) {
+		count += p->wait_hist[i];
 	}
+	return count;
+}
 
-	print("PID  NAME                 STATUS       PRIO  PPID  FD_R  FD_W  STACK_BASE    "
-	      "STACK_PTR\n");
-	print("------------------------------------------------------------------------------------"
-	      "--\n");
-
-	for (int i = 0; i < count; i++) {
-		process_info_t *p = &processes[i];
-
-		// PID
-		printf("%d    ", p->pid);
+// Detalle de un proceso con el histograma de su espera en READY (ps <pid>)
+static void print_details(process_info_t *p)
+{
+	uint64_t waits = wait_count(p);
 
-		// Nombre
-		print(p->name);
+	printf("PID %d (%s)\n", p->pid, p->name);
+	printf("CPU ticks: %d\n", p->cpu_ticks);
+	printf("Wakeups: %d\n", p->wakeups);
+	printf("Group: %d\n", p->group);
+	printf("Class: %s\n", p->deadline ? "real-time" : p->batch ? "batch" : "normal");
+	if (p->owner_pid != p->pid) {
+		printf("Thread of: %d\n", p->owner_pid);
+	}
+	printf("Switches: %d voluntary, %d involuntary\n",
+	       p->voluntary_switches,
+	       p->involuntary_switches);
+	printf("Ready waits: %d, avg %d us, max %d us\n",
+	       waits,
+	       waits ? p->wait_total_ns / waits / NS_PER_US : 0,
+	       p->wait_max_ns / NS_PER_US);
 
-		// Rellenar espacios para alinear (nombre max 20 chars)
-		int name_len = strlen(p->name);
-		for (int j = name_len; j < 21; j++) {
-			putchar(' ');
+	uint32_t max = 0;
+	for (int i = 0; i < WAIT_HIST_BUCKETS; i++) {
+		if (p->wait_hist[i] > max) {
+			max = p->wait_hist[i];
 		}
+	}
+	if (max == 0) {
+		return;
+	}
 
-		// Status
-		if (p->status == PS_READY) {
-			print("READY        ");
-		} else if (p->status == PS_RUNNING) {
-			print("RUNNING      ");
-		} else if (p->status == PS_BLOCKED) {
-			print("BLOCKED      ");
-		} else if (p->status == PS_TERMINATED) {
-			print("TERMINATED   ");
+	print("WAIT (us)          COUNT\n");
+	for (int i = 0; i < WAIT_HIST_BUCKETS; i++) {
+		if (p->wait_hist[i] == 0) {
+			continue;
+		}
+		if (i == WAIT_HIST_BUCKETS - 1) {
+			printf(">= %d     %d  ", 1 << i, p->wait_hist[i]);
 		} else {
-			print("UNKNOWN      ");
+			printf("%d - %d     %d  ", i ? 1 << i : 0, (1 << (i + 1)) - 1, p->wait_hist[i]);
+		}
+		int bar = (int)((uint64_t)p->wait_hist[i] * HIST_BAR_WIDTH / max);
+		for (int j = 0; j < (bar ? bar : 1); j++) {
+			putchar('#');
 		}
+		putchar('\n');
+	}
+}
+
+static void print_row(process_info_t *p)
+{
+	// PID
+	printf("%d    ", p->pid);
+
+	// Nombre
+	print(p->name);
+
+	// Rellenar espacios para alinear (nombre max 20 chars)
+	int name_len = strlen(p->name);
+	for (int j = name_len; j < 21; j++) {
+		putchar(' ');
+	}
+
+	// Status
+	if (p->status == PS_READY) {
+		print("READY        ");
+	} else if (p->status == PS_RUNNING) {
+		print("RUNNING      ");
+	} else if (p->status == PS_BLOCKED) {
+		print("BLOCKED      ");
+	} else if (p->status == PS_TERMINATED) {
+		print("TERMINATED   ");
+	} else {
+		print("UNKNOWN      ");
+	}
 
-		// Prioridad
+	// Prioridad (RT: clase de tiempo real, B: clase batch)
+	if (p->deadline) {
+		print("RT    ");
+	} else if (p->batch) {
+		print("B     ");
+	} else {
 		printf("%d     ", p->priority);
+	}
+
+	// Grupo con cuota de CPU
+	printf("%d    ", p->group);
+
+	if (p->parent_pid < 0) {
+		print("-     "); // no parent pid
+	} else {
+		printf("%d     ", p->parent_pid);
+	}
+
+	// FDs
+	printf("%d     %d     ", p->read_fd, p->write_fd);
+
+	// Stack pointers en hex
+	printf("0x%x      0x%x      ", p->stack_base, p->stack_pointer);
+
+	// Cambios de contexto voluntarios (cedió la CPU) e involuntarios (desalojado)
+	printf("%d       %d       ", p->voluntary_switches, p->involuntary_switches);
 
-		if (p->parent_pid < 0) {
-			print("-     "); // no parent pid
+	// CPU en la que está corriendo (o en cuya cola espera)
+	printf("%d    ", p->cpu);
+
+	// Deadlines perdidos (solo para los que alguna vez fueron de tiempo real)
+	if (p->deadline || p->missed_deadlines > 0) {
+		printf("%d     ", p->missed_deadlines);
+	} else {
+		print("-     ");
+	}
+
+	// Ticks de CPU, despertares y espera en READY (promedio y máxima, en us)
+	uint64_t waits = wait_count(p);
+	printf("%d     %d     %d      %d\n",
+	       p->cpu_ticks,
+	       p->wakeups,
+	       waits ? p->wait_total_ns / waits / NS_PER_US : 0,
+	       p->wait_max_ns / NS_PER_US);
+}
+
+// Uso de CPU de cada grupo: ticks en el período actual sobre la cuota y ticks totales
+static void print_groups(void)
+{
+	group_info_t groups[MAX_GROUPS];
+	int          count = sys_groups_info(groups, MAX_GROUPS);
+	if (count <= 0) {
+		return;
+	}
+
+	print("\nGROUP  PROCS  USED/QUOTA  PERIOD  TOTAL_TICKS  THROTTLES\n");
+	for (int i = 0; i < count; i++) {
+		group_info_t *g = &groups[i];
+		printf("%d      %d      ", g->id, g->processes);
+		if (g->quota == 0) {
+			print("-           -       ");
 		} else {
-			printf("%d     ", p->parent_pid);
+			printf("%d/%d       %d     ", g->period_used, g->quota, g->period);
 		}
+		printf("%d          %d", g->total_ticks, g->throttles);
+		print(g->throttled ? "  (throttled)\n" : "\n");
+	}
+}
 
-		// FDs
-		printf("%d     %d     ", p->read_fd, p->write_fd);
+// Detalle de un solo proceso (ps <pid>)
+static int print_process(int pid)
+{
+	process_info_t process;
+	if (sys_process_info(pid, &process) < 0) {
+		print_err("ps: no process with that PID\n");
+		return ERROR;
+	}
+	print_details(&process);
+	return OK;
+}
 
-		// Stack pointers en hex
-		printf("0x%x      0x%x\n", p->stack_base, p->stack_pointer);
+int ps_main(int argc, char *argv[])
+{
+	if (argc > 1) {
+		print_err("Usage: ps [<pid>]\n");
+		return ERROR;
+	}
+
+	if (argc == 1) {
+		int ret = print_process(satoi(argv[0]));
+		putchar(EOF);
+		return ret;
+	}
+
+	// Lugar para los procesos que hay ahora y unos pocos que se creen antes de pedir la tabla
+	int             max       = sys_process_count() + EXTRA_PROCESSES;
+	process_info_t *processes = malloc(max * sizeof(process_info_t));
+	if (processes == NULL) {
+		print_err("Failed to get processes info\n");
+		return 1;
+	}
+
+	int count = sys_processes_info(processes, max);
+	if (count < 0) {
+		print_err("Failed to get processes info\n");
+		free(processes);
+		return 1;
+	}
+
+	print("PID  NAME                 STATUS       PRIO  GRP  PPID  FD_R  FD_W  STACK_BASE    "
+	      "STACK_PTR     VCSW    ICSW    CPU  MISS  TICKS WAKE  WAIT_US MAX_US\n");
+	print("------------------------------------------------------------------------------------"
+	      "---------------------------------------------------------------\n");
+
+	for (int i = 0; i < count; i++) {
+		print_row(&processes[i]);
 	}
+	free(processes);
 
+	print_groups();
 	putchar(EOF);
 	return OK;
 }
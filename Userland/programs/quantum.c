@@ -0,0 +1,38 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "usrlib.h"
+
+int quantum_main(int argc, char *argv[])
+{
+	if (argc == 0) {
+		for (int prio = MAX_PRIORITY; prio <= MIN_PRIORITY; prio++) {
+			int ticks = sys_set_quantum(prio, 0);
+			if (ticks == ERROR) {
+				// El scheduler fair-share reparte el tiempo por peso, sin quantum fijo
+				printf("Priority %d: no fixed quantum\n", prio);
+			} else {
+				printf("Priority %d: %d ticks\n", prio, ticks);
+			}
+		}
+		return OK;
+	}
+
+	if (argc != 2) {
+		print_err("Usage: quantum [<priority> <ticks>]\n");
+		return ERROR;
+	}
+
+	int prio  = satoi(argv[0]);
+	int ticks = satoi(argv[1]);
+
+	if (ticks <= 0 || sys_set_quantum(prio, ticks) == ERROR) {
+		printf("Failed to change quantum. Check priority range (%d-%d) and ticks.\n",
+		       MAX_PRIORITY,
+		       MIN_PRIORITY);
+		return ERROR;
+	}
+
+	printf("Quantum of priority %d set to %d ticks\n", prio, ticks);
+	return OK;
+}
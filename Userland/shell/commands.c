@@ -15,6 +15,7 @@ static void help(int argc, char *argv[]);
 static void username_cmd(int argc, char *argv[]);
 
 static bool is_cmd_background(char *line);
+static bool is_cmd_batch(char ***tokens, int *token_count);
 
 static BuiltinCommand builtins[] = {
         {"clear", "clears the screen", &cls},
@@ -25,7 +26,7 @@ static BuiltinCommand builtins[] = {
 
 static ExternalProgram programs[] = {
         {"ps", "prints to STDOUT information about current processes", &ps_main},
-        {"mem", "prints to STDOUT memory usage information", &mem_main},
+        {"mem", "prints to STDOUT memory usage information (-f: block cost per request size)", &mem_main},
         {"pipes", "prints to STDOUT information about open pipes", &pipes_main},
         {"time", "prints system time to STDOUT", &time_main},
         {"date", "prints system date to STDOUT", &date_main},
@@ -42,11 +43,33 @@ static ExternalProgram programs[] = {
         {"block", "blocks a process given its pid", &block_main},
         {"unblock", "unblocks a blocked process given its pid", &unblock_main},
         {"nice", "changes the priority of a process", &nice_main},
+        {"quantum", "shows or changes the time slice of a priority", &quantum_main},
+        {"group", "moves a process (and its future children) to a CPU group", &group_main},
+        {"cpuquota", "limits the CPU time of a group per period", &cpuquota_main},
         {"test_mm", "runs an mm test", &test_mm},
         {"test_prio", "runs a priority test", &test_prio},
         {"test_processes", "runs an process test", &test_processes},
         {"test_sync", "runs a sync test with or without semaphores", &test_sync},
         {"test_pipes", "runs a named pipes test", &test_pipes},
+        {"test_sched", "measures the scheduler cost per tick as ready processes grow", &test_sched},
+        {"test_smp", "runs CPU-bound workers and shows how they spread across CPUs", &test_smp},
+        {"test_idle", "counts scheduler wakeups on idle CPUs while sleeping", &test_idle},
+        {"test_clock", "measures nanosleep accuracy with the nanosecond clock", &test_clock},
+        {"test_fair", "shows the CPU share of workers with different priorities", &test_fair},
+        {"test_deadline", "runs periodic real-time tasks and counts missed deadlines", &test_deadline},
+        {"test_mlfq", "measures the wakeup latency of a pipe reader next to CPU hogs", &test_mlfq},
+        {"test_fpu", "checks that SSE registers survive context switches", &test_fpu},
+        {"test_pingpong", "measures semaphore ping-pong latency between two processes", &test_pingpong},
+        {"test_waitany", "waits for children in the order they exit", &test_waitany},
+        {"test_fanout", "keeps many idle child processes alive, then wakes and reaps them", &test_fanout},
+        {"test_pi", "shows priority inversion on a mutex and how inheritance fixes it", &test_pi},
+        {"test_stack", "spawns processes with a given stack size and measures the cost", &test_stack},
+        {"test_spawn", "measures how many short-lived processes per second can be spawned", &test_spawn},
+        {"test_quota", "runs a CPU-bound process in a limited group next to an unlimited one", &test_quota},
+        {"test_batch", "times foreground work next to normal and next to batch CPU hogs", &test_batch},
+        {"test_threads", "compares spawning and joining threads against processes", &test_threads},
+        {"test_slab", "creates and destroys pipes and checks the kernel object caches reuse them", &test_slab},
+        {"test_malloc", "compares usrlib malloc/free with sys_malloc/sys_free for small objects", &test_malloc},
         {NULL, NULL}};
 
 // Busca el operador '|' en los tokens y retorna su índice, o -1 si no existe
@@ -125,7 +148,8 @@ static process_entry_t find_program_entry(char *name)
 	return NULL;
 }
 
-static int try_external_program(char *name, int argc, char **argv, bool background)
+// batch: el proceso pasa a la clase batch (corre solo cuando no hay otros procesos listos)
+static int try_external_program(char *name, int argc, char **argv, bool background, bool batch)
 {
 	process_entry_t entry = find_program_entry(name);
 
@@ -140,6 +164,10 @@ static int try_external_program(char *name, int argc, char **argv, bool backgrou
 		return 0;
 	}
 
+	if (batch) {
+		sys_set_batch(pid, true);
+	}
+
 	if (background) {
 		sys_adopt_init_as_parent(
 		        pid); // los hago huerfanos para que cuando terminen se liberen solos
@@ -155,8 +183,12 @@ static int try_external_program(char *name, int argc, char **argv, bool backgrou
 }
 
 // Ejecuta dos comandos conectados por pipe: left_cmd | right_cmd
-static int execute_piped_commands(
-        char **left_tokens, int left_count, char **right_tokens, int right_count, bool background)
+static int execute_piped_commands(char **left_tokens,
+                                  int    left_count,
+                                  char **right_tokens,
+                                  int    right_count,
+                                  bool   background,
+                                  bool   batch)
 {
 	// Validar que ambos comandos existen
 	char *left_cmd  = left_tokens[0];
@@ -220,6 +252,11 @@ static int execute_piped_commands(
 		return 0;
 	}
 
+	if (batch) {
+		sys_set_batch(pid_left, true);
+		sys_set_batch(pid_right, true);
+	}
+
 	if (background) {
 		// Background: hacer huérfanos a ambos procesos
 		sys_adopt_init_as_parent(pid_left);
@@ -230,9 +267,16 @@ static int execute_piped_commands(
 	// Foreground: establecer el último proceso como foreground para poder matarlo con Ctrl+C
 	sys_set_foreground_process(pid_left);
 
-	// Esperar a que terminen ambos procesos
-	sys_wait(pid_left);
-	sys_wait(pid_right);
+	// Esperar a que terminen ambos procesos, en el orden en que terminen
+	for (int pending = 2; pending > 0;) {
+		int64_t pid = sys_waitany(NULL);
+		if (pid < 0) {
+			break;
+		}
+		if (pid == pid_left || pid == pid_right) {
+			pending--;
+		}
+	}
 	sys_clear_input_buffer(); // limpiar buffer de entrada por si quedó algo
 	putchar('\n');
 
@@ -259,17 +303,31 @@ static bool is_cmd_background(char *line)
 	return background;
 }
 
+// Prefijo "batch <comando>": lo saca de los tokens
+static bool is_cmd_batch(char ***tokens, int *token_count)
+{
+	if (*token_count < 2 || strcmp((*tokens)[0], "batch") != 0) {
+		return false;
+	}
+	(*tokens)++;
+	(*token_count)--;
+	return true;
+}
+
 void process_line(char *line)
 {
 	bool background = is_cmd_background(line);
 
-	char *tokens[MAX_ARGS];
-	int   token_count = parse_input(line, tokens);
+	char  *token_buffer[MAX_ARGS];
+	char **tokens      = token_buffer;
+	int    token_count = parse_input(line, tokens);
 
 	if (token_count == 0) {
 		return;
 	}
 
+	bool batch = is_cmd_batch(&tokens, &token_count);
+
 	// Buscar si hay un operador pipe '|'
 	int pipe_idx = find_pipe_operator(tokens, token_count);
 
@@ -296,7 +354,7 @@ void process_line(char *line)
 
 		// Ejecutar con pipe (pasando el flag background)
 		execute_piped_commands(
-		        left_tokens, left_count, right_tokens, right_count, background);
+		        left_tokens, left_count, right_tokens, right_count, background, batch);
 		return;
 	}
 
@@ -305,13 +363,13 @@ void process_line(char *line)
 	char **argv    = &tokens[1];      // argv[0] es el primer argumento
 	int    argc    = token_count - 1; // argc no cuenta el comando
 
-	// Primero buscar en builtins
-	if (try_builtin_command(command, argc, argv)) {
+	// Primero buscar en builtins (corren dentro de la shell: batch no se aplica)
+	if (!batch && try_builtin_command(command, argc, argv)) {
 		return;
 	}
 
 	// Luego buscar en programas externos
-	if (try_external_program(command, argc, argv, background)) {
+	if (try_external_program(command, argc, argv, background, batch)) {
 		return;
 	}
 
@@ -343,7 +401,8 @@ static void help(int argc, char *argv[])
 
 	print("\nExternal programs:\n");
 	print("--Type <program_name> & to run in background, else it runs in foreground--\n");
-	print("--Type <program_1> | <program_2> to pipe 2 programs--\n\n");
+	print("--Type <program_1> | <program_2> to pipe 2 programs--\n");
+	print("--Type batch <program> to run it only when no other process is ready--\n\n");
 	for (int i = 0; programs[i].name != NULL; i++) {
 		print("  ");
 		print(programs[i].name);
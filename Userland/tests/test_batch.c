@@ -0,0 +1,99 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Mide cuánto tarda el test en hacer un trabajo CPU-bound fijo: solo, junto a procesos CPU-bound
+// normales y junto a la misma cantidad de procesos CPU-bound de la clase batch. Con los batch
+// debería tardar casi lo mismo que solo, porque solo corren cuando no hay nada más listo; al
+// final muestra cuántos ticks de CPU usaron igual los batch (en las CPUs que quedaron libres).
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_HOGS 16
+#define NS_PER_MS 1000000
+
+// Ticks de CPU que usaron los procesos indicados
+static uint64_t hogs_ticks(int64_t *hogs, int64_t count)
+{
+	process_info_t info;
+	uint64_t       total = 0;
+
+	for (int j = 0; j < count; j++) {
+		if (sys_process_info(hogs[j], &info) == 0) {
+			total += info.cpu_ticks;
+		}
+	}
+	return total;
+}
+
+// Devuelve cuánto tardó el trabajo (en ns) con hog_count procesos CPU-bound de la clase indicada
+// corriendo al mismo tiempo. En hog_ticks deja los ticks de CPU que usaron.
+static uint64_t run_case(bool batch, int64_t hog_count, uint64_t work, uint64_t *hog_ticks)
+{
+	int64_t     hogs[MAX_HOGS];
+	const char *no_argv[] = {0};
+	const char *name      = batch ? "batch_hog" : "normal_hog";
+
+	for (int i = 0; i < hog_count; i++) {
+		hogs[i] = sys_create_process(&endless_loop, 0, no_argv, name, NULL);
+		if (batch) {
+			sys_set_batch(hogs[i], true);
+		}
+	}
+
+	uint64_t start = sys_clock_ns();
+	bussy_wait(work);
+	uint64_t elapsed = sys_clock_ns() - start;
+
+	*hog_ticks = hogs_ticks(hogs, hog_count);
+	for (int i = 0; i < hog_count; i++) {
+		sys_kill(hogs[i]);
+		sys_wait(hogs[i]);
+	}
+	return elapsed;
+}
+
+int test_batch(int argc, char *argv[])
+{
+	int64_t hog_count, work;
+
+	if (argc != 2) {
+		print_err("Error: test_batch requires exactly 2 arguments\n");
+		print_err("Usage: test_batch <cpu_bound> <work>\n");
+		print_err("  cpu_bound: amount of CPU-bound processes running meanwhile\n");
+		print_err("  work: busy loop iterations measured\n");
+		print_err("Example: test_batch 8 200000000\n");
+		return -1;
+	}
+
+	if ((hog_count = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid cpu_bound value ");
+		print_err(argv[0]);
+		print_err("\ncpu_bound must be a positive integer\n");
+		return -1;
+	}
+
+	if ((work = satoi(argv[1])) <= 0) {
+		print_err("Error: invalid work value ");
+		print_err(argv[1]);
+		print_err("\nwork must be a positive integer\n");
+		return -1;
+	}
+
+	if (hog_count > MAX_HOGS) {
+		printf("Warning: cpu_bound too high, using %d\n", MAX_HOGS);
+		hog_count = MAX_HOGS;
+	}
+
+	uint64_t normal_ticks, batch_ticks;
+	uint64_t alone  = run_case(false, 0, work, &normal_ticks);
+	uint64_t normal = run_case(false, hog_count, work, &normal_ticks);
+	uint64_t batch  = run_case(true, hog_count, work, &batch_ticks);
+
+	printf("CPU-bound processes: %d\n", hog_count);
+	printf("work alone: %d ms\n", alone / NS_PER_MS);
+	printf("work next to normal processes: %d ms (they used %d ticks)\n", normal / NS_PER_MS,
+	       normal_ticks);
+	printf("work next to batch processes: %d ms (they used %d ticks)\n", batch / NS_PER_MS,
+	       batch_ticks);
+	return 0;
+}
@@ -0,0 +1,52 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Mide con sys_clock_ns cuánto duerme realmente sys_nanosleep para distintos pedidos, incluidos
+// algunos menores a un tick (10 ms). El error debería ser de microsegundos, no de un tick.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define NS_PER_US 1000
+#define ROUNDS 5
+
+static const uint64_t requests_us[] = {50, 500, 2000, 7500, 25000};
+
+int test_clock(int argc, char *argv[])
+{
+	if (argc != 0) {
+		print_err("Error: test_clock takes no arguments\n");
+		print_err("Usage: test_clock\n");
+		return -1;
+	}
+
+	uint64_t t0 = sys_clock_ns();
+	uint64_t t1 = sys_clock_ns();
+	printf("clock_ns resolution check: consecutive reads differ by %d ns\n", t1 - t0);
+
+	printf("REQUESTED(us)  AVG(us)  MAX ERROR(us)\n");
+	for (uint64_t i = 0; i < sizeof(requests_us) / sizeof(requests_us[0]); i++) {
+		uint64_t requested = requests_us[i] * NS_PER_US;
+		uint64_t total     = 0;
+		uint64_t max_error = 0;
+
+		for (int round = 0; round < ROUNDS; round++) {
+			uint64_t start = sys_clock_ns();
+			sys_nanosleep(requested);
+			uint64_t slept = sys_clock_ns() - start;
+
+			total += slept;
+			if (slept < requested) {
+				print_err("test_clock: ERROR nanosleep returned early\n");
+				return -1;
+			}
+			if (slept - requested > max_error) {
+				max_error = slept - requested;
+			}
+		}
+
+		printf("%d            %d     %d\n", requests_us[i], total / ROUNDS / NS_PER_US,
+		       max_error / NS_PER_US);
+	}
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Corre tareas periódicas de tiempo real (EDF) junto a un proceso CPU-bound de prioridad 0. Las
+// que trabajan menos que su runtime no tendrían que perder ningún deadline, la que trabaja más
+// que su runtime sí, y la última se tiene que rechazar porque la utilización pasaría de 1. Falla si
+// alguna no termina como se esperaba. Conviene correrlo con una sola CPU.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define TICK_NS 10000000 // PIT a 100 Hz
+#define CALIBRATION_ITERATIONS 1000000
+#define POLL_MS 100
+#define REJECTED_RET 1
+
+typedef struct dl_task {
+	const char *runtime; // ticks por período
+	const char *period;  // ticks
+	const char *work;    // ticks de trabajo de cada período
+	const char *expected; // "no misses", "misses" o "rejected"
+} dl_task_t;
+
+// Utilización de las cuatro primeras: 0.2 + 0.3 + 0.2 + 0.2 = 0.9, así que la quinta (0.4) no entra
+static const dl_task_t tasks[] = {
+        {"2", "10", "1", "no misses"},
+        {"3", "10", "1", "no misses"},
+        {"4", "20", "2", "no misses"},
+        {"2", "10", "4", "misses"},
+        {"4", "10", "2", "rejected"},
+};
+#define DL_TASKS ((int)(sizeof(tasks) / sizeof(tasks[0])))
+
+static uint64_t iterations_per_tick;
+
+static void spin(uint64_t iterations)
+{
+	volatile uint64_t i = 0;
+	while (i < iterations) {
+		i++;
+	}
+}
+
+// Cómo terminó una tarea, en los mismos términos que expected
+static const char *outcome(int ret, uint32_t missed)
+{
+	if (ret == REJECTED_RET) {
+		return "rejected";
+	}
+	return missed > 0 ? "misses" : "no misses";
+}
+
+static void calibrate(void)
+{
+	uint64_t start = sys_clock_ns();
+	spin(CALIBRATION_ITERATIONS);
+	uint64_t elapsed = sys_clock_ns() - start;
+	iterations_per_tick =
+	        elapsed ? (uint64_t)CALIBRATION_ITERATIONS * TICK_NS / elapsed : CALIBRATION_ITERATIONS;
+}
+
+// argv: runtime period work jobs
+static int dl_worker(int argc, char *argv[])
+{
+	uint64_t work = satoi(argv[2]) * iterations_per_tick;
+	int64_t  jobs = satoi(argv[3]);
+
+	if (sys_sched_deadline(satoi(argv[0]), satoi(argv[1]), 0) != 0) {
+		return REJECTED_RET;
+	}
+	for (int64_t j = 0; j < jobs; j++) {
+		spin(work);
+		sys_yield(); // fin del trabajo de este período
+	}
+	return 0;
+}
+
+// Espera a que terminen todos los workers y guarda cuántos deadlines perdió cada uno
+static void wait_workers(int64_t *pids, uint32_t *missed)
+{
+	process_info_t info;
+	int            alive;
+
+	do {
+		sys_sleep(POLL_MS);
+		alive = 0;
+		for (int j = 0; j < DL_TASKS; j++) {
+			if (sys_process_info(pids[j], &info) < 0) {
+				continue;
+			}
+			missed[j] = info.missed_deadlines;
+			if (info.status != PS_TERMINATED) {
+				alive++;
+			}
+		}
+	} while (alive > 0);
+}
+
+int test_deadline(int argc, char *argv[])
+{
+	int64_t     pids[DL_TASKS];
+	uint32_t    missed[DL_TASKS] = {0};
+	const char *hog_argv[]       = {0};
+
+	if (argc != 1) {
+		print_err("Error: test_deadline requires exactly 1 argument\n");
+		print_err("Usage: test_deadline <jobs>\n");
+		print_err("  jobs: periods each real-time task runs for\n");
+		print_err("Example: test_deadline 50\n");
+		return -1;
+	}
+
+	if (satoi(argv[0]) <= 0) {
+		print_err("Error: invalid jobs value ");
+		print_err(argv[0]);
+		print_err("\njobs must be a positive integer\n");
+		return -1;
+	}
+
+	calibrate();
+
+	for (int i = 0; i < DL_TASKS; i++) {
+		const char *worker_argv[] = {tasks[i].runtime, tasks[i].period, tasks[i].work, argv[0]};
+		pids[i] = sys_create_process(&dl_worker, 4, worker_argv, "dl_worker", NULL);
+		// Que cada uno pida su admisión antes de crear el siguiente
+		sys_sleep(POLL_MS);
+	}
+
+	// Con la prioridad más alta, el hog se llevaría toda la CPU de los procesos normales
+	int64_t hog = sys_create_process(&endless_loop, 0, hog_argv, "hog", NULL);
+	sys_nice(hog, 0);
+	sys_nice(sys_getpid(), 0);
+
+	wait_workers(pids, missed);
+
+	int failed = 0;
+	printf("PID   RUNTIME  PERIOD  WORK  EXPECTED    RESULT\n");
+	for (int i = 0; i < DL_TASKS; i++) {
+		int ret = sys_wait(pids[i]);
+		failed |= strcmp((char *)outcome(ret, missed[i]), (char *)tasks[i].expected) != 0;
+		printf("%d     %s        %s      %s     %s   ",
+		       pids[i],
+		       tasks[i].runtime,
+		       tasks[i].period,
+		       tasks[i].work,
+		       tasks[i].expected);
+		if (ret == REJECTED_RET) {
+			printf("rejected\n");
+		} else {
+			printf("%d missed\n", missed[i]);
+		}
+	}
+
+	sys_kill(hog);
+	sys_wait(hog);
+
+	if (failed) {
+		print_err("test_deadline: ERROR a task did not end as expected\n");
+		return -1;
+	}
+	print("test_deadline: OK\n");
+	return 0;
+}
@@ -0,0 +1,90 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Corre procesos CPU-bound durante un tiempo fijo y muestra qué parte del trabajo hizo cada uno.
+// Con el scheduler de prioridades el de prioridad 0 se lleva casi todo; con el fair-share
+// (./compile.sh cfs) el reparto sigue los pesos de cada prioridad (~70% / 23% / 7%). Conviene
+// correrlo con una sola CPU para que los procesos compitan entre sí.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define FAIR_WORKERS 3
+
+static volatile uint64_t counters[FAIR_WORKERS];
+
+static int fair_worker(int argc, char *argv[])
+{
+	int idx = satoi(argv[0]);
+	while (1) {
+		counters[idx]++;
+	}
+	return 0;
+}
+
+// Corre un worker por prioridad de prio[] durante ms milisegundos y muestra el reparto
+static void run_phase(const char *title, const int *prio, int ms)
+{
+	static const char *idx_str[FAIR_WORKERS] = {"0", "1", "2"};
+	int64_t            pids[FAIR_WORKERS];
+	uint64_t           total = 0;
+
+	printf("%s\n", title);
+
+	for (int i = 0; i < FAIR_WORKERS; i++) {
+		const char *worker_argv[] = {idx_str[i], NULL};
+		counters[i]               = 0;
+		pids[i] = sys_create_process(&fair_worker, 1, worker_argv, "fair_worker", NULL);
+		if (pids[i] >= 0) {
+			sys_nice(pids[i], prio[i]);
+		}
+	}
+
+	sys_sleep(ms);
+
+	for (int i = 0; i < FAIR_WORKERS; i++) {
+		if (pids[i] >= 0) {
+			sys_kill(pids[i]);
+			sys_wait(pids[i]);
+		}
+		total += counters[i];
+	}
+
+	printf("PID   PRIO   ITERATIONS   SHARE\n");
+	for (int i = 0; i < FAIR_WORKERS; i++) {
+		printf("%d     %d      %d     %d%%\n",
+		       pids[i],
+		       prio[i],
+		       counters[i],
+		       total ? counters[i] * 100 / total : 0);
+	}
+}
+
+int test_fair(int argc, char *argv[])
+{
+	static const int mixed[FAIR_WORKERS] = {0, 1, 2};
+	static const int same[FAIR_WORKERS]  = {1, 1, 1};
+	int64_t          ms;
+
+	if (argc != 1) {
+		print_err("Error: test_fair requires exactly 1 argument\n");
+		print_err("Usage: test_fair <milliseconds>\n");
+		print_err("  milliseconds: how long each phase runs\n");
+		print_err("Example: test_fair 2000\n");
+		return -1;
+	}
+
+	if ((ms = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid milliseconds value ");
+		print_err(argv[0]);
+		print_err("\nmilliseconds must be a positive integer\n");
+		return -1;
+	}
+
+	// Con la prioridad más alta el test no queda relegado detrás de los workers al despertar
+	sys_nice(sys_getpid(), 0);
+
+	run_phase("DIFFERENT PRIORITIES...", mixed, ms);
+	run_phase("SAME PRIORITY...", same, ms);
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Crea muchos hijos que quedan bloqueados en un mismo semáforo (procesos vivos pero ociosos),
+// después los despierta a todos y los espera con sys_waitany. Sirve para ver que la tabla de
+// procesos y las colas de los semáforos no están limitadas a 64 procesos.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define FANOUT_SEM "test_fanout"
+#define NS_PER_US 1000
+
+static int idle_child(int argc, char *argv[])
+{
+	if (sys_sem_open(FANOUT_SEM, 0) == -1) {
+		return -1;
+	}
+	sys_sem_wait(FANOUT_SEM);
+	sys_sem_close(FANOUT_SEM);
+	return 0;
+}
+
+int test_fanout(int argc, char *argv[])
+{
+	const char *no_argv[] = {0};
+	int64_t     children;
+	int64_t     created = 0;
+	int64_t     reaped  = 0;
+
+	if (argc != 1) {
+		print_err("Error: test_fanout requires exactly 1 argument\n");
+		print_err("Usage: test_fanout <children>\n");
+		print_err("  children: amount of idle child processes to keep alive at once\n");
+		print_err("Example: test_fanout 1000\n");
+		return -1;
+	}
+
+	if ((children = satoi(argv[0])) <= 0 || children >= MAX_PROCESSES) {
+		print_err("Error: children must be between 1 and MAX_PROCESSES - 1\n");
+		return -1;
+	}
+
+	if (sys_sem_open(FANOUT_SEM, 0) == -1) {
+		print_err("test_fanout: ERROR opening semaphore\n");
+		return -1;
+	}
+
+	uint64_t start = sys_clock_ns();
+	while (created < children) {
+		if (sys_create_process(&idle_child, 0, no_argv, "idle_child", NULL) < 0) {
+			printf("test_fanout: could only create %d processes\n", created);
+			break;
+		}
+		created++;
+	}
+	uint64_t spawned = sys_clock_ns();
+
+	for (int64_t i = 0; i < created; i++) {
+		sys_sem_post(FANOUT_SEM);
+	}
+	while (sys_waitany(NULL) >= 0) {
+		reaped++;
+	}
+	uint64_t done = sys_clock_ns();
+
+	sys_sem_close(FANOUT_SEM);
+
+	printf("created: %d  reaped: %d\n", created, reaped);
+	printf("spawn: %d us  wake and reap: %d us\n", (spawned - start) / NS_PER_US,
+	       (done - spawned) / NS_PER_US);
+
+	return reaped == created ? 0 : -1;
+}
@@ -0,0 +1,107 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Varios procesos cargan un patrón propio en xmm0-xmm7, giran un rato (dejando que el scheduler
+// los desaloje) y verifican que los registros no cambiaron. Si el kernel no guardara el estado
+// SSE de cada proceso, los patrones se mezclarían entre ellos.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_WORKERS 16
+#define SPIN_ITERATIONS 2000000
+
+// Devuelve 0 si los 8 registros conservaron el patrón durante todo el giro
+static uint64_t check_xmm(uint64_t pattern)
+{
+	uint64_t errors = 0;
+
+	__asm__ volatile("movq %1, %%xmm0\n\t"
+	                 "movq %1, %%xmm1\n\t"
+	                 "movq %1, %%xmm2\n\t"
+	                 "movq %1, %%xmm3\n\t"
+	                 "movq %1, %%xmm4\n\t"
+	                 "movq %1, %%xmm5\n\t"
+	                 "movq %1, %%xmm6\n\t"
+	                 "movq %1, %%xmm7\n\t"
+	                 "mov %2, %%rcx\n"
+	                 "1:\n\t"
+	                 "dec %%rcx\n\t"
+	                 "jnz 1b\n\t"
+	                 ".irp r, 0, 1, 2, 3, 4, 5, 6, 7\n\t"
+	                 "movq %%xmm\\r, %%rdx\n\t"
+	                 "xor %1, %%rdx\n\t"
+	                 "or %%rdx, %0\n\t"
+	                 ".endr\n\t"
+	                 : "+r"(errors)
+	                 : "r"(pattern), "i"(SPIN_ITERATIONS)
+	                 : "rcx", "rdx", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6",
+	                   "xmm7", "cc");
+	return errors;
+}
+
+static int fpu_worker(int argc, char *argv[])
+{
+	uint64_t id         = satoi(argv[0]);
+	int64_t  rounds     = satoi(argv[1]);
+	uint64_t pattern    = (0x0101010101010101ull * (id + 1)) ^ 0xA5A5A5A500000000ull;
+	int      mismatches = 0;
+
+	for (int64_t i = 0; i < rounds; i++) {
+		if (check_xmm(pattern + i) != 0) {
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+int test_fpu(int argc, char *argv[])
+{
+	int64_t pids[MAX_WORKERS];
+	char    ids[MAX_WORKERS][4];
+	int64_t workers;
+	int     created    = 0;
+	int64_t mismatches = 0;
+
+	if (argc != 2) {
+		print_err("Error: test_fpu requires exactly 2 arguments\n");
+		print_err("Usage: test_fpu <workers> <rounds>\n");
+		print_err("  workers: amount of processes using the SSE registers at the same time\n");
+		print_err("  rounds: times each worker loads, spins and checks its registers\n");
+		print_err("Example: test_fpu 4 200\n");
+		return -1;
+	}
+
+	if ((workers = satoi(argv[0])) <= 0 || satoi(argv[1]) <= 0) {
+		print_err("Error: workers and rounds must be positive integers\n");
+		return -1;
+	}
+
+	if (workers > MAX_WORKERS) {
+		printf("Warning: workers too high, using %d\n", MAX_WORKERS);
+		workers = MAX_WORKERS;
+	}
+
+	sched_stats_t before, after;
+	sys_sched_stats(&before);
+
+	while (created < workers) {
+		num_to_str_base(created, ids[created], 10);
+		const char *worker_argv[] = {ids[created], argv[1], NULL};
+		pids[created] = sys_create_process(&fpu_worker, 2, worker_argv, "fpu_worker", NULL);
+		if (pids[created] < 0) {
+			print_err("test_fpu: ERROR creating process\n");
+			break;
+		}
+		created++;
+	}
+
+	for (int i = 0; i < created; i++) {
+		mismatches += sys_wait(pids[i]);
+	}
+
+	sys_sched_stats(&after);
+	printf("workers: %d  mismatches: %d  #NM traps: %d\n", created, mismatches,
+	       after.fpu_traps - before.fpu_traps);
+
+	return mismatches == 0 ? 0 : -1;
+}
@@ -0,0 +1,43 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Duerme el tiempo indicado y cuenta cuántas veces se despertó al scheduler en una CPU sin
+// trabajo. Con tickless idle las CPUs ociosas no reciben ticks, así que debería ser casi 0 en vez
+// de 100 por segundo por CPU.
+#include "usrlib.h"
+#include "test_util.h"
+
+int test_idle(int argc, char *argv[])
+{
+	int64_t milliseconds;
+
+	if (argc != 1) {
+		print_err("Error: test_idle requires exactly 1 argument\n");
+		print_err("Usage: test_idle <milliseconds>\n");
+		print_err("  milliseconds: time to stay idle while measuring\n");
+		print_err("Example: test_idle 2000\n");
+		return -1;
+	}
+
+	if ((milliseconds = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid milliseconds value ");
+		print_err(argv[0]);
+		print_err("\nmilliseconds must be a positive integer\n");
+		return -1;
+	}
+
+	sched_stats_t before, after;
+	sys_sched_stats(&before);
+	uint64_t start = sys_ticks();
+
+	sys_sleep(milliseconds);
+
+	uint64_t elapsed = sys_ticks() - start;
+	sys_sched_stats(&after);
+
+	printf("CPUs: %d  elapsed: %d ticks\n", after.cpu_count, elapsed);
+	printf("Idle wakeups: %d (periodic tick: up to %d)\n",
+	       after.idle_wakeups - before.idle_wakeups, elapsed * after.cpu_count);
+
+	return 0;
+}
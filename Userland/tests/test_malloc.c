@@ -0,0 +1,146 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Compara malloc/free de usrlib con sys_malloc/sys_free para objetos chicos: `rounds` veces aloca
+// MAX_OBJECTS objetos de entre 1 y MAX_OBJECT_SIZE bytes, los escribe, los verifica y los libera,
+// y muestra cuánto tardó en promedio cada alloc + free con cada uno. Al final verifica que malloc
+// devuelva punteros alineados a 16 bytes, que calloc devuelva memoria en cero y que realloc
+// conserve el contenido al agrandar un bloque.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_OBJECTS 64
+#define MAX_OBJECT_SIZE 256
+#define REALLOC_STEPS 6
+#define ALIGNMENT 16
+
+typedef void *(*alloc_fn)(uint64_t size);
+typedef void (*free_fn)(void *ptr);
+
+static void fill(void *ptr, uint8_t value, uint32_t size)
+{
+	uint8_t *p = ptr;
+	for (uint32_t i = 0; i < size; i++) {
+		p[i] = value;
+	}
+}
+
+// Devuelve cuánto tardó (en ns), o -1 si falló una alocación o se pisaron dos objetos
+static int64_t churn(alloc_fn alloc, free_fn release, int64_t rounds)
+{
+	void    *objects[MAX_OBJECTS];
+	uint32_t sizes[MAX_OBJECTS];
+	uint64_t start = sys_clock_ns();
+
+	for (int64_t r = 0; r < rounds; r++) {
+		for (int i = 0; i < MAX_OBJECTS; i++) {
+			sizes[i]   = get_uniform(MAX_OBJECT_SIZE - 1) + 1;
+			objects[i] = alloc(sizes[i]);
+			if (objects[i] == NULL) {
+				return -1;
+			}
+			fill(objects[i], i, sizes[i]);
+		}
+		int failed = 0;
+		for (int i = 0; i < MAX_OBJECTS; i++) {
+			failed |= !memcheck(objects[i], i, sizes[i]);
+			release(objects[i]);
+		}
+		if (failed) {
+			return -1;
+		}
+	}
+	return sys_clock_ns() - start;
+}
+
+// Verifica la alineación de bloques chicos y grandes: de 1 byte a más de 2 KB
+static int check_alignment(void)
+{
+	for (uint32_t size = 1; size <= 4 * 1024; size = size * 2 + 1) {
+		void *ptr = malloc(size);
+		if (ptr == NULL) {
+			return -1;
+		}
+		free(ptr);
+		if ((uint64_t)ptr % ALIGNMENT != 0) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+// Verifica calloc y realloc, y que los pedidos imposibles fallen en vez de dar un bloque chico
+static int check_calloc_realloc(void)
+{
+	if (malloc(UINT64_MAX) != NULL || calloc(UINT64_MAX / 2, 4) != NULL) {
+		return -1;
+	}
+
+	uint8_t *zeroed = calloc(MAX_OBJECTS, sizeof(uint32_t));
+	if (zeroed == NULL || !memcheck(zeroed, 0, MAX_OBJECTS * sizeof(uint32_t))) {
+		return -1;
+	}
+	free(zeroed);
+
+	// Crece de 16 bytes hasta pasar a un pedido grande
+	uint32_t size = 16;
+	uint8_t *ptr  = malloc(size);
+	if (ptr == NULL) {
+		return -1;
+	}
+	fill(ptr, 0xA5, size);
+	for (int i = 0; i < REALLOC_STEPS; i++) {
+		uint8_t *grown = realloc(ptr, size * 4);
+		if (grown == NULL || !memcheck(grown, 0xA5, size)) {
+			free(grown != NULL ? grown : ptr);
+			return -1;
+		}
+		fill(grown + size, 0xA5, size * 3);
+		ptr = grown;
+		size *= 4;
+	}
+	free(ptr);
+	return 0;
+}
+
+int test_malloc(int argc, char *argv[])
+{
+	int64_t rounds;
+
+	if (argc != 1) {
+		print_err("Error: test_malloc requires exactly 1 argument\n");
+		print_err("Usage: test_malloc <rounds>\n");
+		print_err("  rounds: times the objects are allocated and freed\n");
+		print_err("Example: test_malloc 1000\n");
+		return -1;
+	}
+
+	if ((rounds = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid rounds value ");
+		print_err(argv[0]);
+		print_err("\nrounds must be a positive integer\n");
+		return -1;
+	}
+
+	int64_t kernel = churn(&sys_malloc, &sys_free, rounds);
+	int64_t arena  = churn(&malloc, &free, rounds);
+	if (kernel < 0 || arena < 0) {
+		print_err("test_malloc: ERROR allocating or checking objects\n");
+		return -1;
+	}
+	if (check_alignment() < 0) {
+		print_err("test_malloc: ERROR malloc returned a misaligned pointer\n");
+		return -1;
+	}
+	if (check_calloc_realloc() < 0) {
+		print_err("test_malloc: ERROR in calloc or realloc\n");
+		return -1;
+	}
+
+	int64_t pairs = rounds * MAX_OBJECTS;
+	printf("objects of 1-%d bytes, %d alloc + free pairs\n", MAX_OBJECT_SIZE, pairs);
+	printf("sys_malloc/sys_free: %d ns per pair\n", kernel / pairs);
+	printf("malloc/free:         %d ns per pair\n", arena / pairs);
+	print("test_malloc: OK\n");
+	return 0;
+}
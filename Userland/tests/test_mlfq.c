@@ -0,0 +1,114 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Mide cuánto tarda un proceso interactivo (bloqueado leyendo un pipe) en despertarse y correr
+// mientras hay procesos CPU-bound con su misma prioridad. Con la MLFQ los CPU-bound bajan de
+// nivel al gastar su quantum y el lector vuelve a su prioridad base al despertarse, así que la
+// latencia no debería crecer con la cantidad de CPU-bound.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_HOGS 16
+#define SAMPLES 40
+#define INTERVAL_MS 50
+#define PIPE_NAME "test_mlfq"
+#define NS_PER_US 1000
+
+static volatile uint64_t total_latency;
+static volatile uint64_t max_latency;
+static volatile uint64_t samples;
+
+// Lee SAMPLES timestamps del pipe y acumula cuánto tardó en recibir cada uno
+static int latency_reader(int argc, char *argv[])
+{
+	int fds[2];
+	if (sys_open_named_pipe(PIPE_NAME, fds) < 0) {
+		return -1;
+	}
+	sys_close_fd(fds[1]);
+
+	uint64_t sent;
+	for (int i = 0; i < SAMPLES; i++) {
+		if (sys_read(fds[0], (char *)&sent, sizeof(sent)) != sizeof(sent)) {
+			break;
+		}
+		uint64_t latency = sys_clock_ns() - sent;
+		total_latency += latency;
+		if (latency > max_latency) {
+			max_latency = latency;
+		}
+		samples++;
+	}
+
+	sys_close_fd(fds[0]);
+	return 0;
+}
+
+int test_mlfq(int argc, char *argv[])
+{
+	int64_t     hogs[MAX_HOGS];
+	const char *no_argv[] = {0};
+	int64_t     hog_count;
+	int         fds[2];
+
+	if (argc != 1) {
+		print_err("Error: test_mlfq requires exactly 1 argument\n");
+		print_err("Usage: test_mlfq <cpu_bound>\n");
+		print_err("  cpu_bound: amount of CPU-bound processes running meanwhile\n");
+		print_err("Example: test_mlfq 4\n");
+		return -1;
+	}
+
+	if ((hog_count = satoi(argv[0])) < 0) {
+		print_err("Error: invalid cpu_bound value ");
+		print_err(argv[0]);
+		print_err("\ncpu_bound must be a non-negative integer\n");
+		return -1;
+	}
+
+	if (hog_count > MAX_HOGS) {
+		printf("Warning: cpu_bound too high, using %d\n", MAX_HOGS);
+		hog_count = MAX_HOGS;
+	}
+
+	if (sys_open_named_pipe(PIPE_NAME, fds) < 0) {
+		print_err("test_mlfq: ERROR opening pipe\n");
+		return -1;
+	}
+	sys_close_fd(fds[0]);
+
+	// El test escribe con la prioridad más alta para que los envíos salgan a tiempo
+	sys_nice(sys_getpid(), 0);
+
+	total_latency = 0;
+	max_latency   = 0;
+	samples       = 0;
+	int64_t reader =
+	        sys_create_process(&latency_reader, 0, no_argv, "latency_reader", NULL);
+
+	for (int i = 0; i < hog_count; i++) {
+		hogs[i] = sys_create_process(&endless_loop, 0, no_argv, "endless_loop", NULL);
+	}
+
+	for (int i = 0; i < SAMPLES; i++) {
+		sys_sleep(INTERVAL_MS);
+		uint64_t now = sys_clock_ns();
+		sys_write(fds[1], (const char *)&now, sizeof(now));
+	}
+
+	sys_wait(reader);
+	sys_close_fd(fds[1]);
+
+	for (int i = 0; i < hog_count; i++) {
+		sys_kill(hogs[i]);
+		sys_wait(hogs[i]);
+	}
+
+	printf("CPU-bound processes: %d\n", hog_count);
+	printf("Wakeups measured: %d\n", samples);
+	if (samples > 0) {
+		printf("Average latency: %d us\n", total_latency / samples / NS_PER_US);
+		printf("Max latency: %d us\n", max_latency / NS_PER_US);
+	}
+	return 0;
+}
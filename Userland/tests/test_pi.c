@@ -0,0 +1,137 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Inversión de prioridades: un proceso de prioridad 2 toma un mutex, uno de prioridad 0 lo espera
+// y mientras tanto corren procesos CPU-bound de prioridad 1. Se corre dos veces: con un semáforo
+// común de valor 1 (sys_sem_open: el de prioridad 2 compite con los CPU-bound) y con un mutex
+// (sys_mutex_open: el dueño hereda la prioridad 0 y lo suelta enseguida). Muestra cuánto esperó el
+// de prioridad 0 en cada caso.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_HOGS 16
+#define MUTEX_NAME "test_pi_mutex"
+#define HELD_NAME "test_pi_held"
+#define NS_PER_MS 1000000
+
+static volatile uint64_t waited_ns;
+
+// Prioridad 2: toma el mutex, avisa que lo tiene y trabaja antes de soltarlo
+static int low_holder(int argc, char *argv[])
+{
+	sys_nice(sys_getpid(), 2);
+	if (sys_sem_open(MUTEX_NAME, 0) == -1 || sys_sem_open(HELD_NAME, 0) == -1) {
+		return -1;
+	}
+
+	sys_sem_wait(MUTEX_NAME);
+	sys_sem_post(HELD_NAME);
+	bussy_wait(satoi(argv[0]));
+	sys_sem_post(MUTEX_NAME);
+
+	sys_sem_close(MUTEX_NAME);
+	sys_sem_close(HELD_NAME);
+	return 0;
+}
+
+// Prioridad 0: mide cuánto tarda en conseguir el mutex
+static int high_waiter(int argc, char *argv[])
+{
+	sys_nice(sys_getpid(), 0);
+	if (sys_sem_open(MUTEX_NAME, 0) == -1) {
+		return -1;
+	}
+
+	uint64_t start = sys_clock_ns();
+	sys_sem_wait(MUTEX_NAME);
+	waited_ns = sys_clock_ns() - start;
+	sys_sem_post(MUTEX_NAME);
+
+	sys_sem_close(MUTEX_NAME);
+	return 0;
+}
+
+// Devuelve cuánto esperó el proceso de prioridad 0, o -1 si algo falló
+static int64_t run_case(int inherit, int64_t hog_count, char *work)
+{
+	int64_t     hogs[MAX_HOGS];
+	const char *no_argv[]   = {0};
+	const char *work_argv[] = {work, NULL};
+
+	// Mismo valor inicial, distinto modo: solo el mutex sigue a su dueño. Los procesos hijos lo
+	// abren con sys_sem_open, que usa el modo de quien lo creó.
+	int64_t opened = inherit ? sys_mutex_open(MUTEX_NAME) : sys_sem_open(MUTEX_NAME, 1);
+	if (opened == -1 || sys_sem_open(HELD_NAME, 0) == -1) {
+		print_err("test_pi: ERROR opening semaphores\n");
+		return -1;
+	}
+
+	waited_ns   = 0;
+	int64_t low = sys_create_process(&low_holder, 1, work_argv, "pi_low", NULL);
+	sys_sem_wait(HELD_NAME);
+
+	for (int i = 0; i < hog_count; i++) {
+		hogs[i] = sys_create_process(&endless_loop, 0, no_argv, "endless_loop", NULL);
+	}
+
+	int64_t high = sys_create_process(&high_waiter, 0, no_argv, "pi_high", NULL);
+	sys_wait(high);
+
+	for (int i = 0; i < hog_count; i++) {
+		sys_kill(hogs[i]);
+		sys_wait(hogs[i]);
+	}
+	sys_wait(low);
+
+	sys_sem_close(MUTEX_NAME);
+	sys_sem_close(HELD_NAME);
+	return waited_ns;
+}
+
+int test_pi(int argc, char *argv[])
+{
+	int64_t hog_count;
+
+	if (argc != 2) {
+		print_err("Error: test_pi requires exactly 2 arguments\n");
+		print_err("Usage: test_pi <cpu_bound> <work>\n");
+		print_err("  cpu_bound: amount of priority 1 CPU-bound processes running meanwhile\n");
+		print_err("  work: busy loop iterations done while holding the mutex\n");
+		print_err("Example: test_pi 8 50000000\n");
+		return -1;
+	}
+
+	if ((hog_count = satoi(argv[0])) < 0) {
+		print_err("Error: invalid cpu_bound value ");
+		print_err(argv[0]);
+		print_err("\ncpu_bound must be a non-negative integer\n");
+		return -1;
+	}
+
+	if (satoi(argv[1]) <= 0) {
+		print_err("Error: invalid work value ");
+		print_err(argv[1]);
+		print_err("\nwork must be a positive integer\n");
+		return -1;
+	}
+
+	if (hog_count > MAX_HOGS) {
+		printf("Warning: cpu_bound too high, using %d\n", MAX_HOGS);
+		hog_count = MAX_HOGS;
+	}
+
+	// El test crea los procesos con la prioridad más alta para que el de prioridad 0 llegue a
+	// bloquearse mientras el mutex está tomado
+	sys_nice(sys_getpid(), 0);
+
+	int64_t plain = run_case(0, hog_count, argv[1]);
+	int64_t pi    = run_case(1, hog_count, argv[1]);
+	if (plain < 0 || pi < 0) {
+		return -1;
+	}
+
+	printf("CPU-bound processes: %d\n", hog_count);
+	printf("Priority 0 wait without inheritance: %d ms\n", plain / NS_PER_MS);
+	printf("Priority 0 wait with inheritance: %d ms\n", pi / NS_PER_MS);
+	return 0;
+}
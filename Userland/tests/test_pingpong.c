@@ -0,0 +1,87 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Dos procesos se pasan el turno con un par de semáforos: cada vuelta son dos bloqueos y dos
+// desbloqueos, así que mide el costo de la cesión voluntaria de la CPU. También muestra cuántos
+// ticks avanzó el reloj, que no debería depender de la cantidad de vueltas.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define PING_SEM "pingpong_ping"
+#define PONG_SEM "pingpong_pong"
+
+static int pong(int argc, char *argv[])
+{
+	int64_t rounds = satoi(argv[0]);
+
+	if (sys_sem_open(PING_SEM, 0) == -1 || sys_sem_open(PONG_SEM, 0) == -1) {
+		return -1;
+	}
+	for (int64_t i = 0; i < rounds; i++) {
+		sys_sem_wait(PING_SEM);
+		sys_sem_post(PONG_SEM);
+	}
+	sys_sem_close(PING_SEM);
+	sys_sem_close(PONG_SEM);
+	return 0;
+}
+
+int test_pingpong(int argc, char *argv[])
+{
+	int64_t rounds;
+
+	if (argc != 1) {
+		print_err("Error: test_pingpong requires exactly 1 argument\n");
+		print_err("Usage: test_pingpong <rounds>\n");
+		print_err("  rounds: times the two processes hand the CPU to each other\n");
+		print_err("Example: test_pingpong 10000\n");
+		return -1;
+	}
+
+	if ((rounds = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid rounds value ");
+		print_err(argv[0]);
+		print_err("\nrounds must be a positive integer\n");
+		return -1;
+	}
+
+	if (sys_sem_open(PING_SEM, 0) == -1 || sys_sem_open(PONG_SEM, 0) == -1) {
+		print_err("test_pingpong: ERROR opening semaphores\n");
+		return -1;
+	}
+
+	const char *pong_argv[] = {argv[0], NULL};
+	int64_t     pid         = sys_create_process(&pong, 1, pong_argv, "pong", NULL);
+	if (pid < 0) {
+		print_err("test_pingpong: ERROR creating process\n");
+		sys_sem_close(PING_SEM);
+		sys_sem_close(PONG_SEM);
+		return -1;
+	}
+
+	sched_stats_t before, after;
+	sys_sched_stats(&before);
+	uint64_t start_ticks = sys_ticks();
+	uint64_t start       = sys_clock_ns();
+
+	for (int64_t i = 0; i < rounds; i++) {
+		sys_sem_post(PING_SEM);
+		sys_sem_wait(PONG_SEM);
+	}
+
+	uint64_t elapsed = sys_clock_ns() - start;
+	uint64_t ticks   = sys_ticks() - start_ticks;
+	sys_sched_stats(&after);
+
+	sys_wait(pid);
+	sys_sem_close(PING_SEM);
+	sys_sem_close(PONG_SEM);
+
+	uint64_t decisions = after.ticks - before.ticks;
+	printf("rounds: %d  avg round trip: %d ns  clock ticks: %d\n", rounds, elapsed / rounds,
+	       ticks);
+	printf("scheduler decisions: %d  avg cycles per decision: %d\n", decisions,
+	       decisions ? (after.total_cycles - before.total_cycles) / decisions : 0);
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Corre dos procesos CPU-bound en grupos distintos: uno limitado a percent ticks de CPU cada 100
+// ticks y otro sin límite. Muestra qué porcentaje del tiempo transcurrido usó cada grupo: el
+// limitado no debería pasar de percent (ni el otro quedar por debajo de lo que le deja libre).
+#include "usrlib.h"
+#include "test_util.h"
+
+#define LIMITED_GROUP (MAX_GROUPS - 1)
+#define UNLIMITED_GROUP (MAX_GROUPS - 2)
+#define QUOTA_PERIOD 100 // ticks
+
+// Ticks de CPU que lleva usados el grupo
+static uint64_t group_ticks(int group)
+{
+	group_info_t groups[MAX_GROUPS];
+	int          count = sys_groups_info(groups, MAX_GROUPS);
+	for (int i = 0; i < count; i++) {
+		if (groups[i].id == group) {
+			return groups[i].total_ticks;
+		}
+	}
+	return 0;
+}
+
+int test_quota(int argc, char *argv[])
+{
+	const char *no_argv[] = {0};
+	int64_t     percent, ms;
+
+	if (argc != 2) {
+		print_err("Error: test_quota requires exactly 2 arguments\n");
+		print_err("Usage: test_quota <percent> <milliseconds>\n");
+		print_err("  percent: CPU share allowed to the limited group (1 to 100)\n");
+		print_err("  milliseconds: how long both processes run\n");
+		print_err("Example: test_quota 30 2000\n");
+		return -1;
+	}
+
+	if ((percent = satoi(argv[0])) <= 0 || percent > QUOTA_PERIOD) {
+		print_err("Error: invalid percent value ");
+		print_err(argv[0]);
+		print_err("\npercent must be between 1 and 100\n");
+		return -1;
+	}
+
+	if ((ms = satoi(argv[1])) <= 0) {
+		print_err("Error: invalid milliseconds value ");
+		print_err(argv[1]);
+		print_err("\nmilliseconds must be a positive integer\n");
+		return -1;
+	}
+
+	if (sys_group_quota(LIMITED_GROUP, percent, QUOTA_PERIOD) == -1) {
+		print_err("test_quota: ERROR setting the quota\n");
+		return -1;
+	}
+
+	int64_t limited   = sys_create_process(&endless_loop, 0, no_argv, "limited", NULL);
+	int64_t unlimited = sys_create_process(&endless_loop, 0, no_argv, "unlimited", NULL);
+	sys_set_group(limited, LIMITED_GROUP);
+	sys_set_group(unlimited, UNLIMITED_GROUP);
+
+	uint64_t limited_start   = group_ticks(LIMITED_GROUP);
+	uint64_t unlimited_start = group_ticks(UNLIMITED_GROUP);
+	uint64_t start           = sys_ticks();
+
+	sys_sleep(ms);
+
+	uint64_t limited_ticks   = group_ticks(LIMITED_GROUP) - limited_start;
+	uint64_t unlimited_ticks = group_ticks(UNLIMITED_GROUP) - unlimited_start;
+	uint64_t elapsed         = sys_ticks() - start;
+
+	sys_kill(limited);
+	sys_kill(unlimited);
+	sys_wait(limited);
+	sys_wait(unlimited);
+	sys_group_quota(LIMITED_GROUP, 0, 0);
+
+	if (elapsed == 0) {
+		print_err("test_quota: ERROR no ticks elapsed\n");
+		return -1;
+	}
+
+	printf("elapsed: %d ticks  quota: %d ticks every %d\n", elapsed, percent, QUOTA_PERIOD);
+	printf("limited group: %d ticks (%d%%)\n", limited_ticks, limited_ticks * 100 / elapsed);
+	printf("unlimited group: %d ticks (%d%%)\n", unlimited_ticks,
+	       unlimited_ticks * 100 / elapsed);
+	return 0;
+}
@@ -0,0 +1,91 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Mide el costo de cada decisión del scheduler (en ciclos de TSC) a medida que crece la cantidad
+// de procesos listos. Con colas O(1) el promedio por tick debería mantenerse plano.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_TEST_PROCESSES (MAX_PROCESSES - 8) // dejamos lugar para init, shell y el test
+#define WARMUP_MS 200
+#define SAMPLE_MS 1000
+
+int test_sched(int argc, char *argv[])
+{
+	int64_t    *pids;
+	const char *loop_argv[] = {0};
+	int64_t     max_processes;
+	int         created = 0;
+
+	if (argc != 1) {
+		print_err("Error: test_sched requires exactly 1 argument\n");
+		print_err("Usage: test_sched <max_processes>\n");
+		print_err("  max_processes: maximum amount of ready processes to measure\n");
+		print_err("Example: test_sched 32\n");
+		return -1;
+	}
+
+	if ((max_processes = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid max_processes value ");
+		print_err(argv[0]);
+		print_err("\nmax_processes must be a positive integer\n");
+		return -1;
+	}
+
+	if (max_processes > MAX_TEST_PROCESSES) {
+		printf("Warning: max_processes too high, using %d\n", MAX_TEST_PROCESSES);
+		max_processes = MAX_TEST_PROCESSES;
+	}
+
+	// En el heap: con miles de procesos posibles no entra en el stack
+	if ((pids = malloc(max_processes * sizeof(int64_t))) == NULL) {
+		print_err("test_sched: ERROR allocating memory\n");
+		return -1;
+	}
+
+	printf("READY   TICKS   AVG_CYCLES/TICK\n");
+
+	for (int target = 1; created < max_processes; target *= 2) {
+		if (target > max_processes) {
+			target = max_processes;
+		}
+
+		// Crear procesos hasta llegar a target procesos listos
+		while (created < target) {
+			pids[created] =
+			        sys_create_process(&endless_loop, 0, loop_argv, "endless_loop", NULL);
+			if (pids[created] < 0) {
+				print_err("test_sched: ERROR creating process\n");
+				break;
+			}
+			created++;
+		}
+
+		sys_sleep(WARMUP_MS);
+
+		sched_stats_t before, after;
+		sys_sched_stats(&before);
+		sys_sleep(SAMPLE_MS);
+		sys_sched_stats(&after);
+
+		uint64_t ticks  = after.ticks - before.ticks;
+		uint64_t cycles = after.total_cycles - before.total_cycles;
+		printf("%d      %d     %d\n", created, ticks, ticks ? cycles / ticks : 0);
+
+		if (created < target) {
+			break;
+		}
+	}
+
+	sched_stats_t total;
+	sys_sched_stats(&total);
+	printf("Worst case: %d cycles in a single decision\n", total.max_cycles);
+
+	for (int i = 0; i < created; i++) {
+		sys_kill(pids[i]);
+		sys_wait(pids[i]);
+	}
+	free(pids);
+
+	return 0;
+}
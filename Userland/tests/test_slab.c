@@ -0,0 +1,95 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Crea y destruye `rounds` veces un pipe (un pipe_t, dos semáforos y nodos de la queue de índices
+// libres en el kernel) y muestra cuánto tardó cada ciclo. Verifica con sys_slab_info que los caches
+// de pipes y semáforos vuelvan a los objetos en uso del principio y que no hayan pedido slabs
+// nuevos después del primer ciclo: los objetos liberados se reusan.
+#include "usrlib.h"
+#include "test_util.h"
+
+// Objetos en uso y slabs del cache name (0 y 0 si todavía no se usó)
+static void cache_usage(const char *name, uint32_t *objects, uint32_t *slabs)
+{
+	slab_info_t caches[MAX_SLAB_CACHES];
+	int         count = sys_slab_info(caches, MAX_SLAB_CACHES);
+
+	*objects = 0;
+	*slabs   = 0;
+	for (int i = 0; i < count; i++) {
+		if (strcmp(caches[i].name, (char *)name) == 0) {
+			*objects = caches[i].objects;
+			*slabs   = caches[i].slabs;
+		}
+	}
+}
+
+static int pipe_cycle(void)
+{
+	int fds[2];
+	int id = sys_create_pipe(fds);
+	if (id < 0) {
+		return -1;
+	}
+	sys_destroy_pipe(id);
+	return 0;
+}
+
+int test_slab(int argc, char *argv[])
+{
+	int64_t rounds;
+
+	if (argc != 1) {
+		print_err("Error: test_slab requires exactly 1 argument\n");
+		print_err("Usage: test_slab <rounds>\n");
+		print_err("  rounds: pipes created and destroyed\n");
+		print_err("Example: test_slab 10000\n");
+		return -1;
+	}
+
+	if ((rounds = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid rounds value ");
+		print_err(argv[0]);
+		print_err("\nrounds must be a positive integer\n");
+		return -1;
+	}
+
+	uint32_t pipes_before, sems_before, pipe_slabs, sem_slabs, unused;
+	cache_usage("pipe", &pipes_before, &unused);
+	cache_usage("semaphore", &sems_before, &unused);
+
+	// El primer ciclo puede tener que pedir un slab
+	if (pipe_cycle() < 0) {
+		print_err("test_slab: ERROR creating pipe\n");
+		return -1;
+	}
+	cache_usage("pipe", &unused, &pipe_slabs);
+	cache_usage("semaphore", &unused, &sem_slabs);
+
+	uint64_t start = sys_clock_ns();
+	for (int64_t i = 1; i < rounds; i++) {
+		if (pipe_cycle() < 0) {
+			print_err("test_slab: ERROR creating pipe\n");
+			return -1;
+		}
+	}
+	uint64_t elapsed = sys_clock_ns() - start;
+
+	uint32_t pipes_after, sems_after, pipe_slabs_after, sem_slabs_after;
+	cache_usage("pipe", &pipes_after, &pipe_slabs_after);
+	cache_usage("semaphore", &sems_after, &sem_slabs_after);
+
+	if (rounds > 1) {
+		printf("pipe create + destroy: %d ns\n", elapsed / (rounds - 1));
+	}
+	if (pipes_after != pipes_before || sems_after != sems_before) {
+		print_err("test_slab: ERROR objects leaked\n");
+		return -1;
+	}
+	if (pipe_slabs_after != pipe_slabs || sem_slabs_after != sem_slabs) {
+		print_err("test_slab: ERROR freed objects were not reused\n");
+		return -1;
+	}
+	print("test_slab: OK\n");
+	return 0;
+}
@@ -0,0 +1,97 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Corre N procesos CPU-bound que hacen el mismo trabajo y mide cuánto tardan en total. Con varias
+// CPUs (CPUS=4 ./run.sh) el tiempo debería bajar casi linealmente, y el muestreo de ps muestra
+// en qué CPU corrió cada uno.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_WORKERS 16
+#define MAX_SAMPLED_CPUS 16
+#define SAMPLE_MS 50
+
+static int smp_worker(int argc, char *argv[])
+{
+	bussy_wait(satoi(argv[0]));
+	return 0;
+}
+
+// Devuelve cuántos de los workers siguen vivos y suma en running_on las muestras en RUNNING
+static int sample_workers(int64_t *pids, int workers, uint64_t *running_on)
+{
+	process_info_t info;
+	int            alive = 0;
+
+	for (int j = 0; j < workers; j++) {
+		if (sys_process_info(pids[j], &info) < 0 || info.status == PS_TERMINATED) {
+			continue;
+		}
+		alive++;
+		if (info.status == PS_RUNNING && info.cpu < MAX_SAMPLED_CPUS) {
+			running_on[info.cpu]++;
+		}
+	}
+	return alive;
+}
+
+int test_smp(int argc, char *argv[])
+{
+	int64_t     pids[MAX_WORKERS];
+	uint64_t    running_on[MAX_SAMPLED_CPUS] = {0};
+	const char *worker_argv[]                = {argv[1], NULL};
+	int64_t     workers;
+	int         created = 0;
+
+	if (argc != 2) {
+		print_err("Error: test_smp requires exactly 2 arguments\n");
+		print_err("Usage: test_smp <workers> <iterations>\n");
+		print_err("  workers: amount of CPU-bound processes to run at the same time\n");
+		print_err("  iterations: busy-wait iterations done by each worker\n");
+		print_err("Example: test_smp 4 100000000\n");
+		return -1;
+	}
+
+	if ((workers = satoi(argv[0])) <= 0 || satoi(argv[1]) <= 0) {
+		print_err("Error: workers and iterations must be positive integers\n");
+		return -1;
+	}
+
+	if (workers > MAX_WORKERS) {
+		printf("Warning: workers too high, using %d\n", MAX_WORKERS);
+		workers = MAX_WORKERS;
+	}
+
+	sched_stats_t before, after;
+	sys_sched_stats(&before);
+	uint64_t start = sys_ticks();
+
+	while (created < workers) {
+		pids[created] = sys_create_process(&smp_worker, 1, worker_argv, "smp_worker", NULL);
+		if (pids[created] < 0) {
+			print_err("test_smp: ERROR creating process\n");
+			break;
+		}
+		created++;
+	}
+
+	while (sample_workers(pids, created, running_on) > 0) {
+		sys_sleep(SAMPLE_MS);
+	}
+
+	uint64_t elapsed = sys_ticks() - start;
+	sys_sched_stats(&after);
+
+	for (int i = 0; i < created; i++) {
+		sys_wait(pids[i]);
+	}
+
+	printf("CPUs: %d  workers: %d  elapsed: %d ticks  migrations: %d\n", after.cpu_count,
+	       created, elapsed, after.migrations - before.migrations);
+	printf("CPU   SAMPLES RUNNING\n");
+	for (uint64_t cpu = 0; cpu < after.cpu_count && cpu < MAX_SAMPLED_CPUS; cpu++) {
+		printf("%d     %d\n", cpu, running_on[cpu]);
+	}
+
+	return 0;
+}
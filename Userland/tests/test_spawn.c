@@ -0,0 +1,86 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Crea y espera uno tras otro procesos que terminan enseguida, como hace la shell con cada comando,
+// y muestra cuántos procesos por segundo se pueden crear. Primero con un argv corto (entra en el
+// PCB) y después con uno largo (se aloca aparte). Cada hijo verifica que recibió bien su argv.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define NS_PER_SEC 1000000000ull
+#define LONG_ARGC 16
+
+static const char *short_argv[] = {"echo", "hello", NULL};
+
+static const char *long_argv[LONG_ARGC + 1] = {
+        "argument-00-padding-padding", "argument-01-padding-padding", "argument-02-padding-padding",
+        "argument-03-padding-padding", "argument-04-padding-padding", "argument-05-padding-padding",
+        "argument-06-padding-padding", "argument-07-padding-padding", "argument-08-padding-padding",
+        "argument-09-padding-padding", "argument-10-padding-padding", "argument-11-padding-padding",
+        "argument-12-padding-padding", "argument-13-padding-padding", "argument-14-padding-padding",
+        "argument-15-padding-padding", NULL};
+
+// Devuelve 0 si los argumentos son los que mandó el test
+static int spawned(int argc, char *argv[])
+{
+	const char **expected = argc == LONG_ARGC ? long_argv : short_argv;
+	for (int i = 0; i < argc; i++) {
+		if (argv[i] == NULL || strcmp(argv[i], (char *)expected[i]) != 0) {
+			return -1;
+		}
+	}
+	return argv[argc] == NULL ? 0 : -1;
+}
+
+// Devuelve los procesos por segundo, o -1 si alguno falló
+static int64_t spawn_rate(int64_t processes, int argc, const char **argv)
+{
+	uint64_t start = sys_clock_ns();
+
+	for (int64_t i = 0; i < processes; i++) {
+		if (sys_create_process(&spawned, argc, argv, "spawned", NULL) < 0) {
+			print_err("test_spawn: ERROR creating process\n");
+			return -1;
+		}
+		int64_t status;
+		sys_waitany(&status);
+		if (status != 0) {
+			print_err("test_spawn: ERROR child received a wrong argv\n");
+			return -1;
+		}
+	}
+
+	uint64_t elapsed = sys_clock_ns() - start;
+	return elapsed ? processes * NS_PER_SEC / elapsed : 0;
+}
+
+int test_spawn(int argc, char *argv[])
+{
+	int64_t processes;
+
+	if (argc != 1) {
+		print_err("Error: test_spawn requires exactly 1 argument\n");
+		print_err("Usage: test_spawn <processes>\n");
+		print_err("  processes: processes created and waited one after the other\n");
+		print_err("Example: test_spawn 5000\n");
+		return -1;
+	}
+
+	if ((processes = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid processes value ");
+		print_err(argv[0]);
+		print_err("\nprocesses must be a positive integer\n");
+		return -1;
+	}
+
+	int64_t short_rate = spawn_rate(processes, 2, short_argv);
+	int64_t long_rate  = spawn_rate(processes, LONG_ARGC, long_argv);
+	if (short_rate < 0 || long_rate < 0) {
+		return -1;
+	}
+
+	printf("processes: %d\n", processes);
+	printf("short argv: %d processes/s\n", short_rate);
+	printf("long argv: %d processes/s\n", long_rate);
+	return 0;
+}
@@ -0,0 +1,101 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Crea y espera uno tras otro procesos con un stack del tamaño pedido, que usan la mitad de su
+// stack con una recursión. Muestra el costo promedio de crear y esperar cada proceso y la memoria usada
+// antes y después: los stacks liberados quedan en un pool del kernel, así que no debería crecer.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define FRAME_BYTES 256
+#define FRAME_OVERHEAD 64 // dirección de retorno, rbp y lo que guarde el compilador en cada llamada
+#define BYTES_PER_KB 1024
+
+static uint64_t use_stack(uint64_t depth)
+{
+	volatile uint8_t frame[FRAME_BYTES];
+	for (int i = 0; i < FRAME_BYTES; i++) {
+		frame[i] = (uint8_t)(depth + i);
+	}
+	uint64_t sum = depth == 0 ? 0 : use_stack(depth - 1);
+	return sum + frame[depth % FRAME_BYTES];
+}
+
+static int stack_user(int argc, char *argv[])
+{
+	uint64_t depth = satoi(argv[0]) / 2 / (FRAME_BYTES + FRAME_OVERHEAD);
+	use_stack(depth);
+	return 0;
+}
+
+int test_stack(int argc, char *argv[])
+{
+	int64_t stack_kb, rounds;
+
+	if (argc != 2) {
+		print_err("Error: test_stack requires exactly 2 arguments\n");
+		print_err("Usage: test_stack <stack_kb> <rounds>\n");
+		print_err("  stack_kb: stack size of each process, in KB (4 to 64)\n");
+		print_err("  rounds: processes created and waited one after the other\n");
+		print_err("Example: test_stack 32 1000\n");
+		return -1;
+	}
+
+	if ((stack_kb = satoi(argv[0])) <= 0 || stack_kb * BYTES_PER_KB > MAX_STACK_SIZE) {
+		print_err("Error: invalid stack_kb value ");
+		print_err(argv[0]);
+		print_err("\nstack_kb must be between 1 and 64\n");
+		return -1;
+	}
+
+	if ((rounds = satoi(argv[1])) <= 0) {
+		print_err("Error: invalid rounds value ");
+		print_err(argv[1]);
+		print_err("\nrounds must be a positive integer\n");
+		return -1;
+	}
+
+	uint64_t    stack_size = stack_kb * BYTES_PER_KB;
+	char        size_str[21];
+	const char *user_argv[] = {size_str, NULL};
+	num_to_str_base(stack_size, size_str, 10);
+
+	// Un stack más grande que el máximo se rechaza
+	if (sys_create_process_stack(&stack_user, 1, user_argv, "stack_user", NULL,
+	                             MAX_STACK_SIZE * 2) >= 0) {
+		print_err("test_stack: ERROR oversized stack was accepted\n");
+		return -1;
+	}
+
+	mem_info_t before = sys_mem_info();
+	uint64_t   total  = 0;
+	uint64_t   first  = 0;
+	int        failed = 0;
+
+	for (int64_t i = 0; i < rounds; i++) {
+		uint64_t start = sys_clock_ns();
+		int64_t  pid   = sys_create_process_stack(&stack_user, 1, user_argv, "stack_user", NULL,
+		                                          stack_size);
+		if (pid < 0) {
+			print_err("test_stack: ERROR creating process\n");
+			return -1;
+		}
+		int64_t status;
+		sys_waitany(&status);
+		uint64_t elapsed = sys_clock_ns() - start;
+		failed += status != 0;
+
+		if (i == 0) {
+			first = elapsed;
+		}
+		total += elapsed;
+	}
+
+	mem_info_t after = sys_mem_info();
+
+	printf("stack: %d KB  rounds: %d  failed: %d\n", stack_kb, rounds, failed);
+	printf("first spawn: %d ns  avg spawn+exit: %d ns\n", first, total / rounds);
+	printf("used memory before: %d bytes  after: %d bytes\n", before.used_memory,
+	       after.used_memory);
+	return failed == 0 ? 0 : -1;
+}
@@ -0,0 +1,119 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Crea 1, 2, 4, ... hasta `count` hilos que incrementan cada uno su lugar de un arreglo compartido
+// y los espera con sys_thread_join; después hace lo mismo con procesos (sys_create_process y
+// sys_waitany). Muestra cuánto tardó cada tanda: los hilos no copian argv ni abren fds. También
+// verifica que cada hilo haya recibido su argumento y devuelto su valor.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_WORKERS 512
+#define NS_PER_US 1000
+
+static int64_t tids[MAX_WORKERS];
+static int64_t slots[MAX_WORKERS];
+
+static int worker_thread(void *arg)
+{
+	int64_t *slot = arg;
+	(*slot)++;
+	return (int)(slot - slots);
+}
+
+static int worker_process(int argc, char *argv[])
+{
+	return 0;
+}
+
+// Devuelve cuánto tardaron en crearse y terminar count hilos (en ns), o -1 si alguno falló
+static int64_t run_threads(int64_t count)
+{
+	uint64_t start = sys_clock_ns();
+
+	for (int64_t i = 0; i < count; i++) {
+		slots[i] = 0;
+		tids[i]  = sys_thread_create(&worker_thread, &slots[i], 0);
+		if (tids[i] < 0) {
+			print_err("test_threads: ERROR creating thread\n");
+			return -1;
+		}
+	}
+
+	int failed = 0;
+	for (int64_t i = 0; i < count; i++) {
+		int64_t status;
+		if (sys_thread_join(tids[i], &status) != 0 || status != i || slots[i] != 1) {
+			failed = 1;
+		}
+	}
+
+	uint64_t elapsed = sys_clock_ns() - start;
+	if (failed) {
+		print_err("test_threads: ERROR a thread got a wrong argument\n");
+		return -1;
+	}
+	return elapsed;
+}
+
+// Lo mismo con procesos
+static int64_t run_processes(int64_t count)
+{
+	const char *no_argv[] = {0};
+	uint64_t    start     = sys_clock_ns();
+
+	for (int64_t i = 0; i < count; i++) {
+		if (sys_create_process(&worker_process, 0, no_argv, "worker", NULL) < 0) {
+			print_err("test_threads: ERROR creating process\n");
+			return -1;
+		}
+	}
+	for (int64_t i = 0; i < count; i++) {
+		sys_waitany(NULL);
+	}
+
+	return sys_clock_ns() - start;
+}
+
+int test_threads(int argc, char *argv[])
+{
+	int64_t count;
+
+	if (argc != 1) {
+		print_err("Error: test_threads requires exactly 1 argument\n");
+		print_err("Usage: test_threads <count>\n");
+		print_err("  count: most threads (and processes) alive at the same time\n");
+		print_err("Example: test_threads 256\n");
+		return -1;
+	}
+
+	if ((count = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid count value ");
+		print_err(argv[0]);
+		print_err("\ncount must be a positive integer\n");
+		return -1;
+	}
+
+	if (count > MAX_WORKERS) {
+		printf("Warning: count too high, using %d\n", MAX_WORKERS);
+		count = MAX_WORKERS;
+	}
+
+	print("COUNT   THREADS (us)   PROCESSES (us)\n");
+	// Potencias de 2 y, al final, count
+	for (int64_t n = 1;; n *= 2) {
+		if (n > count) {
+			n = count;
+		}
+		int64_t threads   = run_threads(n);
+		int64_t processes = run_processes(n);
+		if (threads < 0 || processes < 0) {
+			return -1;
+		}
+		printf("%d       %d             %d\n", n, threads / NS_PER_US,
+		       processes / NS_PER_US);
+		if (n == count) {
+			return 0;
+		}
+	}
+}
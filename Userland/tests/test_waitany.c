@@ -0,0 +1,78 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Crea hijos que duermen tiempos decrecientes y los espera con sys_waitany: tienen que volver en
+// el orden en que terminan (el último creado primero), cada uno una sola vez y con su valor de
+// retorno. Sin hijos, sys_waitany devuelve -1 en vez de bloquearse.
+#include "usrlib.h"
+#include "test_util.h"
+
+#define MAX_CHILDREN 16
+#define STEP_MS 20
+
+static int sleeper(int argc, char *argv[])
+{
+	int64_t index = satoi(argv[0]);
+	int64_t total = satoi(argv[1]);
+	sys_sleep((total - index) * STEP_MS);
+	return index;
+}
+
+int test_waitany(int argc, char *argv[])
+{
+	int64_t pids[MAX_CHILDREN];
+	char    indexes[MAX_CHILDREN][4];
+	int64_t children;
+	int     created = 0;
+	int     errors  = 0;
+
+	if (argc != 1) {
+		print_err("Error: test_waitany requires exactly 1 argument\n");
+		print_err("Usage: test_waitany <children>\n");
+		print_err("  children: amount of child processes to create and wait for\n");
+		print_err("Example: test_waitany 8\n");
+		return -1;
+	}
+
+	if ((children = satoi(argv[0])) <= 0) {
+		print_err("Error: invalid children value ");
+		print_err(argv[0]);
+		print_err("\nchildren must be a positive integer\n");
+		return -1;
+	}
+
+	if (children > MAX_CHILDREN) {
+		printf("Warning: children too high, using %d\n", MAX_CHILDREN);
+		children = MAX_CHILDREN;
+	}
+
+	while (created < children) {
+		num_to_str_base(created, indexes[created], 10);
+		const char *sleeper_argv[] = {indexes[created], argv[0], NULL};
+		pids[created] = sys_create_process(&sleeper, 2, sleeper_argv, "sleeper", NULL);
+		if (pids[created] < 0) {
+			print_err("test_waitany: ERROR creating process\n");
+			break;
+		}
+		created++;
+	}
+
+	// Terminan del último creado al primero
+	for (int expected = created - 1; expected >= 0; expected--) {
+		int64_t status;
+		int64_t pid = sys_waitany(&status);
+		if (status != expected || pid != pids[expected]) {
+			printf("ERROR: got pid %d with status %d, expected pid %d\n", pid, status,
+			       pids[expected]);
+			errors++;
+		}
+	}
+
+	if (sys_waitany(NULL) != -1) {
+		print_err("ERROR: sys_waitany without children did not return -1\n");
+		errors++;
+	}
+
+	printf("children: %d  errors: %d\n", created, errors);
+	return errors == 0 ? 0 : -1;
+}
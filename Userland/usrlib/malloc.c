@@ -0,0 +1,223 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Allocator de userland sobre sys_malloc. Los pedidos chicos (hasta MAX_SMALL_BLOCK con el header)
+// salen de una lista de bloques libres por clase de tamaño (potencias de 2 desde 32 bytes);
+// cuando una lista se vacía se pide al kernel un chunk de ARENA_CHUNK_SIZE y se parte entero en
+// bloques de esa clase. Los pedidos grandes van directo a sys_malloc. Así, alocar y liberar objetos
+// chicos no entra al kernel salvo para un chunk nuevo; los chunks no se devuelven.
+//
+// Los punteros que devuelve quedan alineados a ALIGNMENT, como pide el ABI (el compilador puede
+// usar instrucciones SSE alineadas sobre ellos): los bloques y el header miden múltiplos de 16 y
+// empiezan alineados, y sys_malloc solo garantiza 8.
+//
+// Todos los procesos y sus hilos comparten el código y los datos de userland, así que las listas
+// son compartidas. No usan locks (un proceso matado con el lock tomado trabaría a todos): cada
+// lista es una pila lock-free, con un contador en los 16 bits altos del puntero a la cabeza para
+// que un compare-and-swap no confunda una cabeza que se sacó y volvió a ponerse (ABA).
+#include "usrlib.h"
+
+#define ALIGNMENT 16
+#define MIN_SMALL_SHIFT 5 // 32 bytes: el header y al menos 16 bytes del usuario
+#define SIZE_CLASSES 7    // 32, 64, ..., 2048 bytes
+#define MAX_SMALL_BLOCK (1 << (MIN_SMALL_SHIFT + SIZE_CLASSES - 1))
+#define ARENA_CHUNK_SIZE (16 * 1024)
+#define HEADER_SIZE sizeof(header_t)
+#define LARGE_CLASS 0xFF // header de un bloque pedido a sys_malloc
+// El tamaño de un bloque grande va en los 56 bits altos del header, y a sys_malloc se le pide con
+// el header y lo que haga falta para alinearlo
+#define MAX_REQUEST ((UINT64_MAX >> 8) - HEADER_SIZE - ALIGNMENT)
+
+#define TAG_SHIFT 48
+#define POINTER_MASK ((1ull << TAG_SHIFT) - 1)
+
+// Cada bloque empieza con un header de ALIGNMENT bytes. Mientras un bloque chico está libre, el
+// comienzo del header (base, que los chicos no usan) guarda el siguiente libre.
+typedef struct {
+	void    *base; // en los grandes, lo que devolvió sys_malloc (puede estar antes del header)
+	uint64_t info; // la clase en el byte bajo y, en los grandes, el tamaño pedido en el resto
+} header_t;
+
+typedef struct free_block {
+	struct free_block *next;
+} free_block_t;
+
+static uint64_t free_lists[SIZE_CLASSES]; // cabeza de cada lista con su contador (ver arriba)
+
+static inline free_block_t *head_pointer(uint64_t head)
+{
+	return (free_block_t *)(head & POINTER_MASK);
+}
+
+static inline uint64_t make_head(free_block_t *block, uint64_t old_head)
+{
+	return (((old_head >> TAG_SHIFT) + 1) << TAG_SHIFT) | (uint64_t)block;
+}
+
+static inline header_t *header_of(void *ptr)
+{
+	return (header_t *)ptr - 1;
+}
+
+static inline char *align_up(char *ptr)
+{
+	return (char *)(((uint64_t)ptr + ALIGNMENT - 1) & ~(uint64_t)(ALIGNMENT - 1));
+}
+
+// Clase del bloque más chico donde entran size bytes y el header, o -1 si es un pedido grande
+static int size_class(uint64_t size)
+{
+	if (size > MAX_SMALL_BLOCK - HEADER_SIZE) {
+		return -1;
+	}
+	uint64_t block = size + HEADER_SIZE;
+	if (block <= (1 << MIN_SMALL_SHIFT)) {
+		return 0;
+	}
+	return 64 - __builtin_clzll(block - 1) - MIN_SMALL_SHIFT;
+}
+
+static inline uint64_t class_size(int class)
+{
+	return 1ull << (class + MIN_SMALL_SHIFT);
+}
+
+// Pone la lista first..last en la cabeza de la lista de la clase
+static void push_blocks(int class, free_block_t *first, free_block_t *last)
+{
+	uint64_t *list = &free_lists[class];
+	uint64_t  head = __atomic_load_n(list, __ATOMIC_ACQUIRE);
+	do {
+		last->next = head_pointer(head);
+	} while (!__atomic_compare_exchange_n(list, &head, make_head(first, head), true,
+	                                      __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+}
+
+// NULL si la lista está vacía. Leer next de un bloque que otro acaba de sacar es seguro (la memoria
+// sigue ahí) y, si pasó, el compare-and-swap falla porque cambió el contador.
+static free_block_t *pop_block(int class)
+{
+	uint64_t     *list = &free_lists[class];
+	uint64_t      head = __atomic_load_n(list, __ATOMIC_ACQUIRE);
+	free_block_t *block;
+	do {
+		block = head_pointer(head);
+		if (block == NULL) {
+			return NULL;
+		}
+	} while (!__atomic_compare_exchange_n(list, &head, make_head(block->next, head), true,
+	                                      __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+	return block;
+}
+
+// Pide un chunk al kernel, se queda con su primer bloque y pone el resto en la lista de la clase.
+// Si el chunk no viene alineado se pierde el pedazo del principio (y a lo sumo un bloque).
+static free_block_t *refill(int class)
+{
+	char *base = sys_malloc(ARENA_CHUNK_SIZE);
+	if (base == NULL) {
+		return NULL;
+	}
+
+	char    *chunk = align_up(base);
+	uint64_t size  = class_size(class);
+	uint64_t count = (ARENA_CHUNK_SIZE - (chunk - base)) / size;
+	for (uint64_t i = 1; i + 1 < count; i++) {
+		free_block_t *block = (free_block_t *)(chunk + i * size);
+		block->next         = (free_block_t *)(chunk + (i + 1) * size);
+	}
+	if (count > 1) {
+		push_blocks(class, (free_block_t *)(chunk + size),
+		            (free_block_t *)(chunk + (count - 1) * size));
+	}
+	return (free_block_t *)chunk;
+}
+
+void *malloc(uint64_t size)
+{
+	if (size > MAX_REQUEST) {
+		return NULL;
+	}
+
+	int class = size_class(size);
+	if (class < 0) {
+		char *base = sys_malloc(size + HEADER_SIZE + ALIGNMENT);
+		if (base == NULL) {
+			return NULL;
+		}
+		header_t *header = (header_t *)align_up(base);
+		header->base     = base;
+		header->info     = (size << 8) | LARGE_CLASS;
+		return header + 1;
+	}
+
+	free_block_t *block = pop_block(class);
+	if (block == NULL && (block = refill(class)) == NULL) {
+		return NULL;
+	}
+	header_t *header = (header_t *)block;
+	header->info     = class;
+	return header + 1;
+}
+
+void free(void *ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	header_t *header = header_of(ptr);
+	int       class  = header->info & 0xFF;
+	if (class == LARGE_CLASS) {
+		sys_free(header->base);
+		return;
+	}
+	free_block_t *block = (free_block_t *)header;
+	push_blocks(class, block, block);
+}
+
+void *calloc(uint64_t count, uint64_t size)
+{
+	uint64_t total = count * size;
+	if (size != 0 && total / size != count) {
+		return NULL;
+	}
+
+	char *ptr = malloc(total);
+	if (ptr != NULL) {
+		for (uint64_t i = 0; i < total; i++) {
+			ptr[i] = 0;
+		}
+	}
+	return ptr;
+}
+
+void *realloc(void *ptr, uint64_t size)
+{
+	if (ptr == NULL) {
+		return malloc(size);
+	}
+	if (size == 0) {
+		free(ptr);
+		return NULL;
+	}
+
+	uint64_t info  = header_of(ptr)->info;
+	int      class = info & 0xFF;
+	uint64_t old   = class == LARGE_CLASS ? info >> 8 : class_size(class) - HEADER_SIZE;
+	// Si entra en el mismo bloque no se mueve
+	if (size <= old && (class == LARGE_CLASS || size_class(size) == class)) {
+		return ptr;
+	}
+
+	char *new_ptr = malloc(size);
+	if (new_ptr == NULL) {
+		return NULL;
+	}
+	uint64_t copy = size < old ? size : old;
+	for (uint64_t i = 0; i < copy; i++) {
+		new_ptr[i] = ((char *)ptr)[i];
+	}
+	free(ptr);
+	return new_ptr;
+}
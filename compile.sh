@@ -1,9 +1,13 @@
 
-if [ "$1" == "buddy" ]; then
-    MM="USE_BUDDY"
-else
-    MM=""
-fi
+MM=""
+SCHED=""
+for arg in "$@"; do
+    if [ "$arg" == "buddy" ]; then
+        MM="USE_BUDDY"
+    elif [ "$arg" == "cfs" ]; then
+        SCHED="USE_CFS"
+    fi
+done
 
 # Name of the Docker container
 CONTAINER_NAME="tpe_so_2q2025"
@@ -13,12 +17,12 @@ docker start $CONTAINER_NAME
 
 # Clean and build the project in the specified directories
 docker exec -it $CONTAINER_NAME make -C /root/Toolchain clean
-docker exec -it $CONTAINER_NAME make -C /root/Toolchain all MM="$MM"
+docker exec -it $CONTAINER_NAME make -C /root/Toolchain all MM="$MM" SCHED="$SCHED"
 MAKE_ROOT_EXIT_CODE=$?
 
 # Execute the make commands
 docker exec -it $CONTAINER_NAME make -C /root clean
-docker exec -it $CONTAINER_NAME make -C /root all  MM="$MM"
+docker exec -it $CONTAINER_NAME make -C /root all  MM="$MM" SCHED="$SCHED"
 MAKE_TOOLCHAIN_EXIT_CODE=$?
 
 
@@ -43,6 +43,9 @@ else
     esac
 fi
 
+# Cantidad de CPUs de la VM (por defecto 1): CPUS=4 ./run.sh
+SMP_CONFIG="-smp ${CPUS:-1}"
+
 # Ejecutar QEMU con la configuración de audio apropiada
-echo "Ejecutando: qemu-system-x86_64 -hda Image/x64BareBonesImage.qcow2 -m 512 $AUDIO_CONFIG"
-qemu-system-x86_64 -hda Image/x64BareBonesImage.qcow2 -m 512 $AUDIO_CONFIG
\ No newline at end of file
+echo "Ejecutando: qemu-system-x86_64 -hda Image/x64BareBonesImage.qcow2 -m 512 $SMP_CONFIG $AUDIO_CONFIG"
+qemu-system-x86_64 -hda Image/x64BareBonesImage.qcow2 -m 512 $SMP_CONFIG $AUDIO_CONFIG
\ No newline at end of file